@@ -75,6 +75,8 @@ Core::Core(const SInt32 id)
    , m_spin_loops(0)
    , m_spin_instructions(0)
    , m_spin_elapsed_time(SubsecondTime::Zero())
+   , m_warmup_fast_accesses(0)
+   , m_warmup_detailed_accesses(0)
    , m_instructions(0)
    , m_instructions_callback(UINT64_MAX)
    , m_instructions_hpi_callback(0)
@@ -86,6 +88,8 @@ Core::Core(const SInt32 id)
    registerStatsMetric("core", id, "spin_loops", &m_spin_loops);
    registerStatsMetric("core", id, "spin_instructions", &m_spin_instructions);
    registerStatsMetric("core", id, "spin_elapsed_time", &m_spin_elapsed_time);
+   registerStatsMetric("core", id, "warmup-fast-accesses", &m_warmup_fast_accesses);
+   registerStatsMetric("core", id, "warmup-detailed-accesses", &m_warmup_detailed_accesses);
 
    Sim()->getStatsManager()->logTopology("hwcontext", id, id);
 
@@ -263,6 +267,53 @@ void Core::accessMemoryFast(const bool icache, const mem_op_t mem_op_type, const
       m_performance_model->handleMemoryLatency(latency, HitWhere::MISS);
 }
 
+// Functional warming: every cache line is first offered to the memory manager's warming path, which only updates
+// cache state, lines it cannot handle on its own (coherence actions) take the usual MEM_MODELED_COUNT path.
+// The memory lock is held for the whole batch, and only dropped around the accesses that take the detailed path.
+void Core::warmMemory(const WarmupAccess *accesses, const UInt32 count)
+{
+   const UInt64 cache_block_size = getMemoryManager()->getCacheBlockSize();
+
+   m_mem_lock.acquire();
+   getShmemPerfModel()->setElapsedTime(ShmemPerfModel::_USER_THREAD, getPerformanceModel()->getElapsedTime());
+
+   for (UInt32 i = 0; i < count; ++i)
+   {
+      const WarmupAccess &access = accesses[i];
+      const IntPtr end_addr = access.address + access.size;
+
+      for (IntPtr curr_addr_aligned = access.address & ~(cache_block_size - 1); curr_addr_aligned < end_addr; curr_addr_aligned += cache_block_size)
+      {
+         if (access.icache)
+         {
+            // Same line as the last instruction fetch, see readInstructionMemory
+            if (curr_addr_aligned == m_icache_last_block)
+               continue;
+            m_icache_last_block = curr_addr_aligned;
+         }
+
+         if (getMemoryManager()->coreWarmMemoryAccess(access.icache, access.mem_op_type, curr_addr_aligned))
+         {
+            if (m_cheetah_manager)
+               m_cheetah_manager->access(access.mem_op_type, curr_addr_aligned);
+            m_warmup_fast_accesses++;
+         }
+         else
+         {
+            // initiateMemoryAccess takes the memory lock itself
+            m_mem_lock.release();
+            m_warmup_detailed_accesses++;
+            initiateMemoryAccess(access.icache ? MemComponent::L1_ICACHE : MemComponent::L1_DCACHE,
+                  Core::NONE, access.mem_op_type, curr_addr_aligned, nullptr, cache_block_size, MEM_MODELED_COUNT, access.eip, SubsecondTime::MaxTime());
+            m_mem_lock.acquire();
+            getShmemPerfModel()->setElapsedTime(ShmemPerfModel::_USER_THREAD, getPerformanceModel()->getElapsedTime());
+         }
+      }
+   }
+
+   m_mem_lock.release();
+}
+
 MemoryResult
 Core::initiateMemoryAccess(MemComponent::component_t mem_component,
       const lock_signal_t lock_signal,
@@ -78,6 +78,16 @@ class Core
          MEM_MODELED_RETURN,    /* Count + time + return data to construct DynamicInstruction */
       };
 
+      // One memory access of a functional-warming batch (InstMode::CACHE_ONLY)
+      struct WarmupAccess
+      {
+         bool icache;
+         mem_op_t mem_op_type;
+         IntPtr address;
+         UInt32 size;
+         IntPtr eip;
+      };
+
       static const char * CoreStateString(State state);
 
       explicit Core(SInt32 id);
@@ -93,6 +103,7 @@ class Core
       static MemoryResult nativeMemOp(lock_signal_t lock_signal, mem_op_t mem_op_type, IntPtr d_addr, char* data_buffer, UInt32 data_size);
 
       void accessMemoryFast(bool icache, mem_op_t mem_op_type, IntPtr address) const;
+      void warmMemory(const WarmupAccess *accesses, UInt32 count);
 
       void logMemoryHit(bool icache, mem_op_t mem_op_type, IntPtr address, MemModeled modeled = MEM_MODELED_NONE, IntPtr eip = 0) const;
       bool countInstructions(IntPtr address, UInt32 count);
@@ -172,6 +183,9 @@ class Core
       UInt64 m_spin_instructions;
       SubsecondTime m_spin_elapsed_time;
 
+      UInt64 m_warmup_fast_accesses;
+      UInt64 m_warmup_detailed_accesses;
+
       // Added by Kleber Kruger to get PC
       struct program_counter_t {
          program_counter_t() : pc(0), i_pc(0), d_pc(0) {}
@@ -27,7 +27,8 @@ Cache::Cache(
    m_cache_type(cache_type),
    m_fault_injector(fault_injector),
    m_replacement_policy(CacheSet::parsePolicyType(replacement_policy)), // Added by Kleber Kruger
-   m_cache_threshold(getCacheThreshold(cfgname))                        // Added by Kleber Kruger
+   m_cache_threshold(getCacheThreshold(cfgname)),                       // Added by Kleber Kruger
+   m_dirty_tracker(nullptr)
 {
    m_set_info = CacheSet::createCacheSetInfo(name, cfgname, core_id, replacement_policy, m_associativity);
    m_sets = new CacheSet*[m_num_sets];
@@ -37,6 +38,14 @@ Cache::Cache(
       m_sets[i] = CacheSet::createCacheSet(i, cfgname, core_id, m_replacement_policy, m_cache_type, m_associativity, m_blocksize, m_set_info, cache_set_threshold);
    }
 
+   // Keep track of the modified blocks so the checkpoint thresholds can be checked in O(1)
+   if (m_cache_threshold.has_value())
+   {
+      m_dirty_tracker = new CacheDirtyTracker(m_num_sets, m_associativity);
+      for (UInt32 i = 0; i < m_num_sets; i++)
+         m_sets[i]->attachDirtyTracker(m_dirty_tracker, i);
+   }
+
    #ifdef ENABLE_SET_USAGE_HIST
    m_set_usage_hist = new UInt64[m_num_sets];
    for (UInt32 i = 0; i < m_num_sets; i++)
@@ -59,6 +68,14 @@ Cache::~Cache()
    for (SInt32 i = 0; i < static_cast<SInt32>(m_num_sets); i++)
       delete m_sets[i];
    delete [] m_sets;
+   delete m_dirty_tracker;
+}
+
+void
+Cache::enableEpochTagging(const EpochCntlr* epoch_cntlr)
+{
+   for (UInt32 i = 0; i < m_num_sets; i++)
+      m_sets[i]->enableEpochTagging(epoch_cntlr);
 }
 
 Lock&
@@ -142,7 +159,7 @@ Cache::insertSingleLine(const IntPtr addr, const Byte* fill_buff,
    *evict_addr = tagToAddress(evict_block_info->getTag());
 
    // NVM Checkpoint Support (Added by Kleber Kruger)
-   if (Sim()->getProjectType() == ProjectType::DONUTS && getCapacityUsed() >= m_cache_threshold.value())
+   if (m_cache_threshold.has_value() && getCapacityUsed() >= m_cache_threshold.value())
       cntlr->checkpoint(CheckpointReason::CACHE_THRESHOLD, set_index);
 
    if (m_fault_injector) {
@@ -201,13 +218,23 @@ Cache::updateHits(const Core::mem_op_t mem_op_type, const UInt64 hits)
 float
 Cache::getCapacityUsed() const
 {
-   UInt32 count = 0;
-   for (UInt32 i = 0; i < m_num_sets; i++)
+   UInt64 count = 0;
+   if (m_dirty_tracker)
    {
-      for (UInt32 j = 0; j < m_associativity; j++)
+      #ifdef DEBUG_DIRTY_TRACKER
+      m_dirty_tracker->verify(this);
+      #endif
+      count = m_dirty_tracker->getNumDirty();
+   }
+   else
+   {
+      for (UInt32 i = 0; i < m_num_sets; i++)
       {
-         if (peekBlock(i, j)->isDirty())
-            count++;
+         for (UInt32 j = 0; j < m_associativity; j++)
+         {
+            if (peekBlock(i, j)->isDirty())
+               count++;
+         }
       }
    }
    return static_cast<float>(count) / static_cast<float>(m_num_sets * m_associativity);
@@ -221,10 +248,17 @@ float
 Cache::getSetCapacityUsed(const UInt32 index) const
 {
    UInt32 count = 0;
-   for (UInt32 i = 0; i < m_associativity; i++)
+   if (m_dirty_tracker)
+   {
+      count = m_dirty_tracker->getSetNumDirty(index);
+   }
+   else
    {
-      if (m_sets[index]->peekBlock(i)->isDirty())
-         count++;
+      for (UInt32 i = 0; i < m_associativity; i++)
+      {
+         if (m_sets[index]->peekBlock(i)->isDirty())
+            count++;
+      }
    }
    return static_cast<float>(count) / static_cast<float>(m_associativity);
 }
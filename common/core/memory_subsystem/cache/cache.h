@@ -4,6 +4,7 @@
 #include "cache_base.h"
 #include "cache_set.h"
 #include "cache_block_info.h"
+#include "cache_dirty_tracker.h"
 #include "cache_perf_model.h"
 #include "core.h"
 #include "fault_injection.h"
@@ -50,6 +51,10 @@ class Cache : public CacheBase
       [[nodiscard]] float getCapacityUsed() const;                                                  // Added by Kleber Kruger
       [[nodiscard]] float getSetCapacityUsed(UInt32 index) const;                                   // Added by Kleber Kruger
 
+      [[nodiscard]] const CacheDirtyTracker* getDirtyTracker() const { return m_dirty_tracker; }
+      // Stamp the epoch of a persistence domain on the blocks when they become dirty (DONUTS)
+      void enableEpochTagging(const EpochCntlr* epoch_cntlr);
+
       [[nodiscard]] static bool isDonutsAndLLC(const String& cfgname);                              // Added by Kleber Kruger
       [[nodiscard]] static std::optional<float> getCacheThreshold(const String& cfgname);           // Added by Kleber Kruger
 
@@ -74,6 +79,7 @@ protected:
 
       ReplacementPolicy m_replacement_policy; // Added by Kleber Kruger
       std::optional<float> m_cache_threshold; // Added by Kleber Kruger
+      CacheDirtyTracker* m_dirty_tracker;     // Only allocated for the DONUTS LLC
 
 #ifdef ENABLE_SET_USAGE_HIST
       UInt64* m_set_usage_hist;
@@ -3,8 +3,9 @@
 #include "pr_l2_cache_block_info.h"
 #include "shared_cache_block_info.h"
 #include "log.h"
-#include "simulator.h"     // Added by Kleber Kruger
-#include "epoch_manager.h" // Added by Kleber Kruger
+
+#include <new>
+#include "epoch_cntlr.h" // Added by Kleber Kruger
 
 const char* CacheBlockInfo::option_names[] =
 {
@@ -29,7 +30,12 @@ CacheBlockInfo::CacheBlockInfo(const IntPtr tag, const CacheState::cstate_t csta
    m_owner(0),
    m_used(0),
    m_options(options),
-   m_eid(0)                         // Added by Kleber Kruger
+   m_epoch_cntlr(nullptr),
+   m_eid(0),                        // Added by Kleber Kruger
+   m_tag_slot(nullptr),
+   m_dirty_tracker(nullptr),
+   m_set_index(0),
+   m_way(0)
 {}
 
 CacheBlockInfo::~CacheBlockInfo() = default;
@@ -53,10 +59,55 @@ CacheBlockInfo::create(const CacheBase::cache_t cache_type)
    }
 }
 
+template <class T>
+static CacheBlockInfo**
+createBlocks(const UInt32 num_blocks)
+{
+   auto* slab = new Byte[num_blocks * sizeof(T)];
+   auto** blocks = new CacheBlockInfo*[num_blocks];
+   for (UInt32 i = 0; i < num_blocks; i++)
+      blocks[i] = new (slab + i * sizeof(T)) T();
+   return blocks;
+}
+
+CacheBlockInfo**
+CacheBlockInfo::createArray(const CacheBase::cache_t cache_type, const UInt32 num_blocks)
+{
+   LOG_ASSERT_ERROR(num_blocks > 0, "Cannot create an empty array of cache blocks");
+
+   switch (cache_type)
+   {
+      case CacheBase::PR_L1_CACHE:
+         return createBlocks<PrL1CacheBlockInfo>(num_blocks);
+
+      case CacheBase::PR_L2_CACHE:
+         return createBlocks<PrL2CacheBlockInfo>(num_blocks);
+
+      case CacheBase::SHARED_CACHE:
+         return createBlocks<SharedCacheBlockInfo>(num_blocks);
+
+      default:
+         LOG_PRINT_ERROR("Unrecognized cache type (%u)", cache_type);
+   }
+}
+
+void
+CacheBlockInfo::destroyArray(CacheBlockInfo** blocks, const UInt32 num_blocks)
+{
+   // The first block sits at the start of the slab
+   auto* slab = reinterpret_cast<Byte*>(blocks[0]);
+   for (UInt32 i = 0; i < num_blocks; i++)
+      blocks[i]->~CacheBlockInfo();
+   delete[] slab;
+   delete[] blocks;
+}
+
 void
 CacheBlockInfo::invalidate()
 {
-   m_tag = ~0;
+   storeTag(~0);
+   if (m_dirty_tracker)
+      m_dirty_tracker->update(m_set_index, m_way, isDirty(), false);
    m_cstate = CacheState::INVALID;
    m_eid = 0;                       // Added by Kleber Kruger
 }
@@ -64,7 +115,10 @@ CacheBlockInfo::invalidate()
 void
 CacheBlockInfo::clone(CacheBlockInfo* cache_block_info)
 {
-   m_tag = cache_block_info->getTag();
+   storeTag(cache_block_info->getTag());
+   // The tracker belongs to the slot, not to the line: account for the new state but keep our own tracker
+   if (m_dirty_tracker)
+      m_dirty_tracker->update(m_set_index, m_way, isDirty(), cache_block_info->isDirty());
    m_cstate = cache_block_info->getCState();
    m_owner = cache_block_info->m_owner;
    m_used = cache_block_info->m_used;
@@ -96,12 +150,14 @@ void // Modified by Kleber Kruger
 CacheBlockInfo::setCState(const CacheState::cstate_t cstate)
 {
    // Added by Kleber Kruger
-   if (Sim()->getProjectType() == ProjectType::DONUTS && cstate == CacheState::MODIFIED)
+   if (m_epoch_cntlr && cstate == CacheState::MODIFIED)
    {
-      const UInt64 eid = EpochManager::getGlobalSystemEID();
+      const UInt64 eid = m_epoch_cntlr->getCurrentEID();
       // TODO: In the cache_cntlr, case the system tries to write to a cache block from a past epoch not committed, commit it!
       LOG_ASSERT_ERROR(m_cstate != CacheState::MODIFIED || m_eid == eid, "It's not allowed to write to an uncommitted block (%lu -> %lu)", m_eid, eid);
       m_eid = eid;
    }
+   if (m_dirty_tracker)
+      m_dirty_tracker->update(m_set_index, m_way, isDirty(), cstate == CacheState::MODIFIED);
    m_cstate = cstate;
-}
\ No newline at end of file
+}
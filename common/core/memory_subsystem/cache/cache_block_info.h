@@ -5,6 +5,9 @@
 #include "cache_state.h"
 #include "cache_base.h"
 #include "checkpoint_event.h" // Added by Kleber Kruger
+#include "cache_dirty_tracker.h"
+
+class EpochCntlr;
 
 class CacheBlockInfo
 {
@@ -27,10 +30,26 @@ class CacheBlockInfo
       UInt64 m_owner;
       BitsUsedType m_used;
       UInt8 m_options;  // large enough to hold a bitfield for all available option_t's
+      const EpochCntlr* m_epoch_cntlr; // Domain whose epoch is stamped on the block when it becomes dirty (DONUTS)
       UInt64 m_eid;     // Added by Kleber Kruger
 
+      // Copy of the tag in the tag array of the set this block belongs to (only for blocks of a set)
+      IntPtr* m_tag_slot;
+
+      // Dirty-line bookkeeping of the set this block belongs to (only for tracked caches)
+      CacheDirtyTracker* m_dirty_tracker;
+      UInt32 m_set_index;
+      UInt32 m_way;
+
       static const char* option_names[];
 
+      void storeTag(const IntPtr tag)
+      {
+         m_tag = tag;
+         if (m_tag_slot)
+            *m_tag_slot = tag;
+      }
+
    public:
       explicit CacheBlockInfo(IntPtr tag = ~0,
             CacheState::cstate_t cstate = CacheState::INVALID,
@@ -38,6 +57,9 @@ class CacheBlockInfo
       virtual ~CacheBlockInfo();
 
       static CacheBlockInfo* create(CacheBase::cache_t cache_type);
+      // Construct num_blocks blocks by value in one contiguous slab, returns the table of the blocks
+      static CacheBlockInfo** createArray(CacheBase::cache_t cache_type, UInt32 num_blocks);
+      static void destroyArray(CacheBlockInfo** blocks, UInt32 num_blocks);
 
       virtual void invalidate();
       virtual void clone(CacheBlockInfo* cache_block_info);
@@ -49,12 +71,28 @@ class CacheBlockInfo
       [[nodiscard]] CacheState::cstate_t getCState() const { return m_cstate; }
       [[nodiscard]] char getCStateString() const { return CacheState(m_cstate).to_char(); }  // Added by Kleber Kruger
 
-      void setTag(const IntPtr tag) { m_tag = tag; }
+      void setTag(const IntPtr tag) { storeTag(tag); }
       void setCState(CacheState::cstate_t cstate);                                           // Modified by Kleber Kruger
 
       [[nodiscard]] UInt64 getOwner() const { return m_owner; }
       void setOwner(const UInt64 owner) { m_owner = owner; }
 
+      void attachTagSlot(IntPtr* tag_slot)
+      {
+         m_tag_slot = tag_slot;
+         *m_tag_slot = m_tag;
+      }
+
+      void attachDirtyTracker(CacheDirtyTracker* dirty_tracker, const UInt32 set_index, const UInt32 way)
+      {
+         m_dirty_tracker = dirty_tracker;
+         m_set_index = set_index;
+         m_way = way;
+      }
+
+      // Selected once by the cache; like the dirty tracker, it belongs to the slot and is not cloned
+      void enableEpochTagging(const EpochCntlr* epoch_cntlr) { m_epoch_cntlr = epoch_cntlr; }
+
       [[nodiscard]] UInt64 getEpochID() const { return m_eid; }   // Added by Kleber Kruger
       void setEpochID(const UInt64 eid) { m_eid = eid; }          // Added by Kleber Kruger
 
@@ -0,0 +1,65 @@
+#include "cache_dirty_tracker.h"
+#include "cache.h"
+#include "log.h"
+
+CacheDirtyTracker::CacheDirtyTracker(const UInt32 num_sets, const UInt32 associativity) :
+   m_associativity(associativity),
+   m_words_per_set((associativity + 63) / 64),
+   m_num_dirty(0),
+   m_dirty_ways(num_sets * m_words_per_set, 0),
+   m_set_num_dirty(num_sets, 0),
+   m_dirty_sets((num_sets + 63) / 64, 0)
+{ }
+
+CacheDirtyTracker::~CacheDirtyTracker() = default;
+
+void
+CacheDirtyTracker::move(const UInt32 set_index, const UInt32 way, const bool is_dirty)
+{
+   UInt64 *ways = &m_dirty_ways[set_index * m_words_per_set + way / 64];
+   UInt64 *sets = &m_dirty_sets[set_index / 64];
+   const UInt64 way_bit = 1ull << (way % 64), set_bit = 1ull << (set_index % 64);
+
+   if (is_dirty)
+   {
+      __sync_fetch_and_or(ways, way_bit);
+      if (__sync_fetch_and_add(&m_set_num_dirty[set_index], 1) == 0)
+         __sync_fetch_and_or(sets, set_bit);
+      __sync_fetch_and_add(&m_num_dirty, 1);
+   }
+   else
+   {
+      __sync_fetch_and_and(ways, ~way_bit);
+      if (__sync_fetch_and_sub(&m_set_num_dirty[set_index], 1) == 1)
+         __sync_fetch_and_and(sets, ~set_bit);
+      __sync_fetch_and_sub(&m_num_dirty, 1);
+   }
+}
+
+/**
+ * Check the incremental index against a full recount of the cache (debug only).
+ */
+void
+CacheDirtyTracker::verify(const Cache* cache) const
+{
+   UInt64 total = 0;
+   for (UInt32 i = 0; i < m_set_num_dirty.size(); i++)
+   {
+      UInt32 count = 0;
+      for (UInt32 j = 0; j < m_associativity; j++)
+      {
+         const bool tracked = (m_dirty_ways[i * m_words_per_set + j / 64] >> (j % 64)) & 1;
+         LOG_ASSERT_ERROR(tracked == cache->peekBlock(i, j)->isDirty(), "Cache %s: block %u of set %u is %s, but the tracker has it %s",
+                          cache->getName().c_str(), j, i, tracked ? "clean" : "dirty", tracked ? "dirty" : "clean");
+         if (tracked)
+            count++;
+      }
+      LOG_ASSERT_ERROR(count == m_set_num_dirty[i], "Cache %s: set %u has %u dirty blocks, but the tracker counted %u",
+                       cache->getName().c_str(), i, count, m_set_num_dirty[i]);
+      LOG_ASSERT_ERROR(((m_dirty_sets[i / 64] >> (i % 64)) & 1) == (count != 0), "Cache %s: set %u misplaced in the dirty set bitmap",
+                       cache->getName().c_str(), i);
+      total += count;
+   }
+   LOG_ASSERT_ERROR(total == m_num_dirty, "Cache %s: %lu dirty blocks, but the tracker counted %lu",
+                    cache->getName().c_str(), total, m_num_dirty);
+}
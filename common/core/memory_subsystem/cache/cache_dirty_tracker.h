@@ -0,0 +1,96 @@
+#ifndef CACHE_DIRTY_TRACKER_H
+#define CACHE_DIRTY_TRACKER_H
+
+#include "fixed_types.h"
+
+#include <vector>
+
+// Define to cross-check the incremental dirty counters against a full recount of the cache
+//#define DEBUG_DIRTY_TRACKER
+
+class Cache;
+
+/**
+ * Live index of the MODIFIED lines of a cache.
+ *
+ * Blocks attached to a tracker report every transition into and out of the MODIFIED state
+ * (see CacheBlockInfo::setCState). The tracker keeps:
+ *  - a dirty-way bitmap and a dirty counter per set, so the dirty lines of a set are found without probing every way;
+ *  - a bitmap of the sets holding at least one dirty line, to walk them in index order;
+ *  - the total number of dirty lines.
+ *
+ * This allows the DONUTS thresholds to be checked in O(1) and a checkpoint to select its
+ * lines in O(number of dirty lines).
+ *
+ * The counters and bitmaps are updated with atomic operations, so transitions of different sets never
+ * contend on a lock. The transitions of one set are serialized by the set lock of the cache controller.
+ */
+class CacheDirtyTracker
+{
+public:
+   CacheDirtyTracker(UInt32 num_sets, UInt32 associativity);
+   ~CacheDirtyTracker();
+
+   void update(const UInt32 set_index, const UInt32 way, const bool was_dirty, const bool is_dirty)
+   {
+      if (was_dirty != is_dirty)
+         move(set_index, way, is_dirty);
+   }
+
+   [[nodiscard]] UInt32 getAssociativity() const { return m_associativity; }
+   [[nodiscard]] UInt64 getNumDirty() const { return __atomic_load_n(&m_num_dirty, __ATOMIC_RELAXED); }
+   [[nodiscard]] UInt32 getSetNumDirty(const UInt32 set_index) const { return __atomic_load_n(&m_set_num_dirty[set_index], __ATOMIC_RELAXED); }
+
+   // Call func(way) for every dirty way of a set, in increasing way order
+   template <typename F>
+   void forEachDirtyWay(const UInt32 set_index, F func) const
+   {
+      const UInt64 *words = &m_dirty_ways[set_index * m_words_per_set];
+      for (UInt32 word = 0; word < m_words_per_set; word++)
+      {
+         for (UInt64 bits = __atomic_load_n(&words[word], __ATOMIC_RELAXED); bits; bits &= bits - 1)
+            func(word * 64 + __builtin_ctzll(bits));
+      }
+   }
+
+   // Call func(set_index) for every set holding dirty lines, in increasing set index order
+   template <typename F>
+   void forEachDirtySetByIndex(F func) const
+   {
+      for (UInt32 word = 0; word < m_dirty_sets.size(); word++)
+      {
+         for (UInt64 bits = __atomic_load_n(&m_dirty_sets[word], __ATOMIC_RELAXED); bits; bits &= bits - 1)
+            func(word * 64 + __builtin_ctzll(bits));
+      }
+   }
+
+   // Call func(set_index) for every set holding dirty lines, from the fullest to the emptiest
+   // (sets with the same number of dirty lines in increasing set index order)
+   template <typename F>
+   void forEachDirtySetByFillLevel(F func) const
+   {
+      std::vector<std::vector<UInt32>> levels(m_associativity + 1);
+      forEachDirtySetByIndex([&](const UInt32 set_index) { levels[getSetNumDirty(set_index)].push_back(set_index); });
+      for (UInt32 level = m_associativity; level > 0; level--)
+      {
+         for (const UInt32 set_index : levels[level])
+            func(set_index);
+      }
+   }
+
+   void verify(const Cache* cache) const;
+
+private:
+   const UInt32 m_associativity;
+   const UInt32 m_words_per_set;
+
+   UInt64 m_num_dirty;
+
+   std::vector<UInt64> m_dirty_ways;      // Dirty ways of each set, m_words_per_set words per set
+   std::vector<UInt32> m_set_num_dirty;   // Dirty ways of each set
+   std::vector<UInt64> m_dirty_sets;      // Sets with at least one dirty way
+
+   void move(UInt32 set_index, UInt32 way, bool is_dirty);
+};
+
+#endif // CACHE_DIRTY_TRACKER_H
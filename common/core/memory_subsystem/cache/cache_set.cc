@@ -14,16 +14,16 @@
 #include "config.hpp"
 #include "log.h"
 #include "simulator.h"
+#include <algorithm>
 #include <cstring>
 
 CacheSet::CacheSet(const CacheBase::cache_t cache_type, const UInt32 associativity, const UInt32 blocksize) :
-   m_associativity(associativity), m_blocksize(blocksize)
+   m_associativity(associativity), m_blocksize(blocksize), m_dirty_tracker(nullptr)
 {
-   m_cache_block_info_array = new CacheBlockInfo*[m_associativity];
+   m_cache_block_info_array = CacheBlockInfo::createArray(cache_type, m_associativity);
+   m_tags = new IntPtr[m_associativity];
    for (UInt32 i = 0; i < m_associativity; i++)
-   {
-      m_cache_block_info_array[i] = CacheBlockInfo::create(cache_type);
-   }
+      m_cache_block_info_array[i]->attachTagSlot(&m_tags[i]);
 
    if (Sim()->getFaultinjectionManager())
    {
@@ -36,9 +36,8 @@ CacheSet::CacheSet(const CacheBase::cache_t cache_type, const UInt32 associativi
 
 CacheSet::~CacheSet()
 {
-   for (UInt32 i = 0; i < m_associativity; i++)
-      delete m_cache_block_info_array[i];
-   delete[] m_cache_block_info_array;
+   CacheBlockInfo::destroyArray(m_cache_block_info_array, m_associativity);
+   delete[] m_tags;
    delete[] m_blocks;
 }
 
@@ -68,33 +67,49 @@ CacheSet::write_line(const UInt32 line_index, const UInt32 offset, const Byte* i
       updateReplacementIndex(line_index);
 }
 
-CacheBlockInfo*
-CacheSet::find(const IntPtr tag, UInt32* line_index) const
+/**
+ * Scan the tags of the set, 64 ways at a time, without branching on each way so the compare vectorizes.
+ * Like the per-way scan it replaces, the highest matching way wins.
+ */
+SInt32
+CacheSet::findWay(const IntPtr tag) const
 {
-   for (SInt64 index = m_associativity - 1; index >= 0; index--)
+   for (SInt32 base = (m_associativity - 1) & ~63U; base >= 0; base -= 64)
    {
-      if (m_cache_block_info_array[index]->getTag() == tag)
-      {
-         if (line_index != nullptr)
-            *line_index = index;
-         return m_cache_block_info_array[index];
-      }
+      const UInt32 num_ways = std::min<UInt32>(m_associativity - base, 64);
+      const IntPtr* tags = &m_tags[base];
+
+      UInt64 match = 0;
+      for (UInt32 i = 0; i < num_ways; i++)
+         match |= static_cast<UInt64>(tags[i] == tag) << i;
+
+      if (match)
+         return base + 63 - __builtin_clzll(match);
    }
-   return nullptr;
+   return -1;
+}
+
+CacheBlockInfo*
+CacheSet::find(const IntPtr tag, UInt32* line_index) const
+{
+   const SInt32 index = findWay(tag);
+   if (index < 0)
+      return nullptr;
+
+   if (line_index != nullptr)
+      *line_index = index;
+   return m_cache_block_info_array[index];
 }
 
 bool
 CacheSet::invalidate(const IntPtr& tag) const
 {
-   for (SInt64 index = m_associativity - 1; index >= 0; index--)
-   {
-      if (m_cache_block_info_array[index]->getTag() == tag)
-      {
-         m_cache_block_info_array[index]->invalidate();
-         return true;
-      }
-   }
-   return false;
+   const SInt32 index = findWay(tag);
+   if (index < 0)
+      return false;
+
+   m_cache_block_info_array[index]->invalidate();
+   return true;
 }
 
 void
@@ -107,7 +122,7 @@ CacheSet::insert(CacheBlockInfo* cache_block_info, const Byte* fill_buff, bool*
 
    assert(eviction != nullptr);
 
-   if (m_cache_block_info_array[index]->isValid())
+   if (isWayValid(index))
    {
       *eviction = true;
       // FIXME: This is a hack. I dont know if this is the best way to do
@@ -133,6 +148,21 @@ CacheSet::getDataPtr(const UInt32 line_index, const UInt32 offset) const
    return &m_blocks[line_index * m_blocksize + offset];
 }
 
+void
+CacheSet::attachDirtyTracker(CacheDirtyTracker* dirty_tracker, const UInt32 set_index)
+{
+   m_dirty_tracker = dirty_tracker;
+   for (UInt32 i = 0; i < m_associativity; i++)
+      m_cache_block_info_array[i]->attachDirtyTracker(dirty_tracker, set_index, i);
+}
+
+void
+CacheSet::enableEpochTagging(const EpochCntlr* epoch_cntlr)
+{
+   for (UInt32 i = 0; i < m_associativity; i++)
+      m_cache_block_info_array[i]->enableEpochTagging(epoch_cntlr);
+}
+
 CacheSet* // Modified by Kleber Kruger (added arg index and cache_set_threshold)
 CacheSet::createCacheSet(const UInt32 index,
                          const String& cfgname,
@@ -37,9 +37,13 @@ class CacheSet
       void insert(CacheBlockInfo* cache_block_info, const Byte* fill_buff, bool* eviction, CacheBlockInfo* evict_block_info, Byte* evict_buff, CacheCntlr *cntlr = nullptr);
 
       [[nodiscard]] CacheBlockInfo* peekBlock(const UInt32 way) const { return m_cache_block_info_array[way]; }
+      [[nodiscard]] bool isWayValid(const UInt32 way) const { return m_tags[way] != static_cast<IntPtr>(~0L); }
 
       [[nodiscard]] char* getDataPtr(UInt32 line_index, UInt32 offset = 0) const;
 
+      void attachDirtyTracker(CacheDirtyTracker* dirty_tracker, UInt32 set_index);
+      void enableEpochTagging(const EpochCntlr* epoch_cntlr);
+
       virtual UInt32 getReplacementIndex(CacheCntlr *cntlr) = 0;
       virtual void updateReplacementIndex(UInt32) = 0;
 
@@ -54,11 +58,15 @@ class CacheSet
       static UInt8 getNumQBSAttempts(CacheBase::ReplacementPolicy, const String& cfgname, core_id_t core_id);
 
    protected:
-      CacheBlockInfo** m_cache_block_info_array;
+      CacheBlockInfo** m_cache_block_info_array;  // Blocks stored by value in one slab, see CacheBlockInfo::createArray
+      IntPtr* m_tags;                             // Tags of the ways, kept by the blocks, scanned by find and invalidate
       char* m_blocks;
       UInt32 m_associativity;
       UInt32 m_blocksize;
       Lock m_lock;
+      CacheDirtyTracker* m_dirty_tracker;
+
+      [[nodiscard]] SInt32 findWay(IntPtr tag) const;
 };
 
 #endif /* CACHE_SET_H */
\ No newline at end of file
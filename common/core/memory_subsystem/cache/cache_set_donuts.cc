@@ -21,6 +21,24 @@ bool CacheSetDonuts::isValidReplacement(const UInt32 index)
    return state != CacheState::SHARED_UPGRADING && state != CacheState::MODIFIED;
 }
 
+/**
+ * Sets of a cache without dirty-line tracking (e.g. the ATD sets) count their dirty blocks on each call.
+ */
+UInt32
+CacheSetDonuts::getNumDirty() const
+{
+   if (m_dirty_tracker)
+      return m_dirty_tracker->getSetNumDirty(m_index);
+
+   UInt32 count = 0;
+   for (UInt32 i = 0; i < m_associativity; i++)
+   {
+      if (m_cache_block_info_array[i]->isDirty())
+         count++;
+   }
+   return count;
+}
+
 std::optional<float>
 CacheSetDonuts::getCacheSetThreshold(const String& cfgname, const core_id_t core_id)
 {
@@ -20,6 +20,7 @@ protected:
    float m_cache_set_threshold;
 
    bool isValidReplacement(UInt32 index) override;
+   [[nodiscard]] UInt32 getNumDirty() const;
 };
 
 
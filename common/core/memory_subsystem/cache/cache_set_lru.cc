@@ -27,7 +27,7 @@ CacheSetLRU::getReplacementIndex(CacheCntlr *cntlr)
    // First try to find an invalid block
    for (UInt32 i = 0; i < m_associativity; i++)
    {
-      if (!m_cache_block_info_array[i]->isValid())
+      if (!isWayValid(i))
       {
          // Mark our newly-inserted line as most-recently used
          moveToMRU(i);
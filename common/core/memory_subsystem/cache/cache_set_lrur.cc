@@ -23,13 +23,13 @@ CacheSetLRUR::~CacheSetLRUR() = default;
 UInt32
 CacheSetLRUR::getReplacementIndex(CacheCntlr *cntlr)
 {
-   UInt32 index = 0, num_modified = 0;
+   UInt32 index = 0;
    UInt8 max_bits = 0;
 
    // First try to find an invalid block
    for (UInt32 i = 0; i < m_associativity; i++)
    {
-      if (!m_cache_block_info_array[i]->isValid())
+      if (!isWayValid(i))
       {
          // Mark our newly-inserted line as most-recently used
          moveToMRU(i);
@@ -42,13 +42,10 @@ CacheSetLRUR::getReplacementIndex(CacheCntlr *cntlr)
          index = i;
          max_bits = m_lru_bits[i];
       }
-
-      // Check if all blocks are modified
-      if (m_cache_block_info_array[i]->isDirty())
-         num_modified++;
    }
 
-   if (num_modified >= static_cast<UInt32>(static_cast<float>(m_associativity) * m_cache_set_threshold))
+   // Check if the modified blocks reached the set threshold
+   if (getNumDirty() >= static_cast<UInt32>(static_cast<float>(m_associativity) * m_cache_set_threshold))
    {
       max_bits = m_associativity - 1;
       // Return the oldest block among the modified ones
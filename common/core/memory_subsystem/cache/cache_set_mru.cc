@@ -25,7 +25,7 @@ CacheSetMRU::getReplacementIndex(CacheCntlr *cntlr)
 
    for (UInt32 i = 0; i < m_associativity; i++)
    {
-      if (!m_cache_block_info_array[i]->isValid())
+      if (!isWayValid(i))
       {
          updateReplacementIndex(i);
          return i;
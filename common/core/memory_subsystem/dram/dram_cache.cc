@@ -203,14 +203,15 @@ void
 DramCache::callPrefetcher(IntPtr train_address, bool cache_hit, bool prefetch_hit, SubsecondTime t_issue)
 {
    // Always train the prefetcher
-   std::vector<IntPtr> prefetchList = m_prefetcher->getNextAddress(train_address, INVALID_CORE_ID);
+   IntPtr prefetchList[Prefetcher::MAX_PREFETCHES];
+   UInt32 numPrefetches = m_prefetcher->getNextAddress(train_address, 0, INVALID_CORE_ID, prefetchList, Prefetcher::MAX_PREFETCHES);
 
    // Only do prefetches on misses, or on hits to lines previously brought in by the prefetcher (if enabled)
    if (!cache_hit || (m_prefetch_on_prefetch_hit && prefetch_hit))
    {
-      for(std::vector<IntPtr>::iterator it = prefetchList.begin(); it != prefetchList.end(); ++it)
+      for(UInt32 i = 0; i < numPrefetches; ++i)
       {
-         IntPtr prefetch_address = *it;
+         IntPtr prefetch_address = prefetchList[i];
          if (!m_cache->peekSingleLine(prefetch_address))
          {
             // Get data from DRAM
@@ -17,6 +17,8 @@ class DramCache : public DramCntlrInterface
 
       virtual boost::tuple<SubsecondTime, HitWhere::where_t> getDataFromDram(IntPtr address, core_id_t requester, Byte* data_buf, SubsecondTime now, ShmemPerf *perf);
       virtual boost::tuple<SubsecondTime, HitWhere::where_t> putDataToDram(IntPtr address, core_id_t requester, Byte* data_buf, SubsecondTime now);
+      // Persists are only durable in memory, they bypass the DRAM cache
+      virtual void persistDataToDram(IntPtr address, Byte* data_buf, SubsecondTime now) { m_dram_cntlr->persistDataToDram(address, data_buf, now); }
 
    private:
       core_id_t m_core_id;
@@ -2,6 +2,10 @@
 #include "memory_manager.h"
 #include "shmem_msg.h"
 #include "shmem_perf.h"
+#include "shmem_batch.h"
+#include "utils.h"
+#include "simulator.h"
+#include "epoch_manager.h"
 #include "log.h"
 
 void DramCntlrInterface::handleMsgFromTagDirectory(core_id_t sender, PrL1PrL2DramDirectoryMSI::ShmemMsg* shmem_msg)
@@ -45,6 +49,25 @@ void DramCntlrInterface::handleMsgFromTagDirectory(core_id_t sender, PrL1PrL2Dra
          break;
       }
 
+      case PrL1PrL2DramDirectoryMSI::ShmemMsg::PERSIST:
+      {
+         // Checkpoint batch: its timing was modelled by the persist scheduler of the checkpoint, on the performance
+         // model of this controller, so only the data is written here
+         Byte* batch_buf = shmem_msg->getDataBuf();
+
+         for (UInt64 i = 0; i < PrL1PrL2DramDirectoryMSI::ShmemBatch::getSize(batch_buf); i++)
+         {
+            persistDataToDram(PrL1PrL2DramDirectoryMSI::ShmemBatch::getAddress(batch_buf, i),
+                              PrL1PrL2DramDirectoryMSI::ShmemBatch::getData(batch_buf, i, getCacheBlockSize()), msg_time);
+         }
+
+         // Shadow the persisted image for the crash-consistency checker
+         if (Sim()->getEpochManager() && Sim()->getEpochManager()->getPersistChecker())
+            Sim()->getEpochManager()->getPersistChecker()->persistBatch(batch_buf);
+
+         break;
+      }
+
       default:
          LOG_PRINT_ERROR("Unrecognized Shmem Msg Type: %u", shmem_msg_type);
          break;
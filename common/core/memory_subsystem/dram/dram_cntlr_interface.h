@@ -40,6 +40,8 @@ class DramCntlrInterface
 
       virtual boost::tuple<SubsecondTime, HitWhere::where_t> getDataFromDram(IntPtr address, core_id_t requester, Byte* data_buf, SubsecondTime now, ShmemPerf *perf) = 0;
       virtual boost::tuple<SubsecondTime, HitWhere::where_t> putDataToDram(IntPtr address, core_id_t requester, Byte* data_buf, SubsecondTime now) = 0;
+      // Write the data of a checkpointed line, without timing (modelled by the checkpoint, see PersistScheduler)
+      virtual void persistDataToDram(IntPtr address, Byte* data_buf, SubsecondTime now) = 0;
 
       void handleMsgFromTagDirectory(core_id_t sender, PrL1PrL2DramDirectoryMSI::ShmemMsg* shmem_msg);
 };
@@ -0,0 +1,223 @@
+#include "dram_data_arena.h"
+#include "log.h"
+#include "utils.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+DramDataArena::DramDataArena(const UInt64 chunk_size, const bool use_mmap)
+   : m_chunk_size(chunk_size)
+   , m_chunk_bits(floorLog2(chunk_size))
+   , m_levels((ADDRESS_BITS - floorLog2(chunk_size) + RADIX_BITS - 1) / RADIX_BITS)
+   , m_use_mmap(use_mmap)
+   , m_root(new Node())
+   , m_num_chunks(0)
+{
+   LOG_ASSERT_ERROR(isPower2(chunk_size) && chunk_size >= 4096 && chunk_size <= (1ULL << 30),
+                    "DRAM arena chunk size (%lu) must be a power of two between 4 KB and 1 GB", chunk_size);
+   LOG_ASSERT_ERROR(!use_mmap || chunk_size % sysconf(_SC_PAGESIZE) == 0,
+                    "DRAM arena chunk size (%lu) must be a multiple of the page size to be mapped", chunk_size);
+}
+
+DramDataArena::~DramDataArena()
+{
+   deleteNode(m_root, 0);
+}
+
+UInt32
+DramDataArena::getIndex(const IntPtr address, const UInt32 level) const
+{
+   return (address >> (m_chunk_bits + (m_levels - 1 - level) * RADIX_BITS)) & (RADIX_SIZE - 1);
+}
+
+Byte*
+DramDataArena::findChunk(const IntPtr address) const
+{
+   const Node* node = m_root;
+   for (UInt32 level = 0; level < m_levels - 1; level++)
+   {
+      node = static_cast<const Node*>(node->entries[getIndex(address, level)]);
+      if (node == nullptr)
+         return nullptr;
+   }
+   return static_cast<Byte*>(node->entries[getIndex(address, m_levels - 1)]);
+}
+
+Byte*
+DramDataArena::allocateChunk(const IntPtr address)
+{
+   LOG_ASSERT_ERROR((address >> ADDRESS_BITS) == 0, "Address %lx is beyond the %u-bit DRAM arena", address, ADDRESS_BITS);
+
+   ScopedLock sl(m_lock);
+
+   Node* node = m_root;
+   for (UInt32 level = 0; level < m_levels - 1; level++)
+   {
+      void*& entry = node->entries[getIndex(address, level)];
+      if (entry == nullptr)
+         entry = new Node();
+      node = static_cast<Node*>(entry);
+   }
+
+   void*& entry = node->entries[getIndex(address, m_levels - 1)];
+   if (entry == nullptr)
+   {
+      entry = newChunk();
+      m_num_chunks++;
+   }
+   return static_cast<Byte*>(entry);
+}
+
+Byte*
+DramDataArena::get(const IntPtr address, const UInt32 size)
+{
+   const UInt64 offset = address & (m_chunk_size - 1);
+   LOG_ASSERT_ERROR(offset + size <= m_chunk_size, "Access [%lx, +%u) crosses a DRAM arena chunk", address, size);
+
+   Byte* chunk = findChunk(address);
+   if (chunk == nullptr)
+      chunk = allocateChunk(address);
+   return chunk + offset;
+}
+
+const Byte*
+DramDataArena::peek(const IntPtr address, const UInt32 size) const
+{
+   const UInt64 offset = address & (m_chunk_size - 1);
+   LOG_ASSERT_ERROR(offset + size <= m_chunk_size, "Access [%lx, +%u) crosses a DRAM arena chunk", address, size);
+
+   const Byte* chunk = findChunk(address);
+   return chunk ? chunk + offset : nullptr;
+}
+
+void
+DramDataArena::release(const IntPtr address, const UInt64 size)
+{
+   ScopedLock sl(m_lock);
+
+   const IntPtr end = address + size;
+   for (IntPtr base = address & ~(m_chunk_size - 1); base < end; base += m_chunk_size)
+   {
+      Byte* chunk = findChunk(base);
+      if (chunk == nullptr)
+         continue;
+
+      const IntPtr start = getMax(address, base), stop = getMin(end, base + m_chunk_size);
+      if (start == base && stop == base + m_chunk_size)
+      {
+         Node* node = m_root;
+         for (UInt32 level = 0; level < m_levels - 1; level++)
+            node = static_cast<Node*>(node->entries[getIndex(base, level)]);
+         node->entries[getIndex(base, m_levels - 1)] = nullptr;
+
+         deleteChunk(chunk);
+         m_num_chunks--;
+      }
+      else if (m_use_mmap)
+      {
+         // Hand the whole pages back (they fault in again zeroed) and clear the partial ones
+         const UInt64 page_size = sysconf(_SC_PAGESIZE);
+         const IntPtr page_start = (start + page_size - 1) & ~(page_size - 1), page_stop = stop & ~(page_size - 1);
+         if (page_start < page_stop)
+         {
+            memset(chunk + (start - base), 0, page_start - start);
+            madvise(chunk + (page_start - base), page_stop - page_start, MADV_DONTNEED);
+            memset(chunk + (page_stop - base), 0, stop - page_stop);
+         }
+         else
+            memset(chunk + (start - base), 0, stop - start);
+      }
+      else
+         memset(chunk + (start - base), 0, stop - start);
+   }
+}
+
+Byte*
+DramDataArena::newChunk() const
+{
+   if (m_use_mmap)
+   {
+      void* chunk = mmap(nullptr, m_chunk_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      LOG_ASSERT_ERROR(chunk != MAP_FAILED, "Could not map a DRAM arena chunk of %lu bytes", m_chunk_size);
+      #ifdef MADV_HUGEPAGE
+      if (m_chunk_size >= (2ULL << 20))
+         madvise(chunk, m_chunk_size, MADV_HUGEPAGE);
+      #endif
+      return static_cast<Byte*>(chunk);
+   }
+
+   auto* chunk = static_cast<Byte*>(calloc(1, m_chunk_size));
+   LOG_ASSERT_ERROR(chunk != nullptr, "Could not allocate a DRAM arena chunk of %lu bytes", m_chunk_size);
+   return chunk;
+}
+
+void
+DramDataArena::deleteChunk(Byte* chunk) const
+{
+   if (m_use_mmap)
+      munmap(chunk, m_chunk_size);
+   else
+      free(chunk);
+}
+
+void
+DramDataArena::deleteNode(Node* node, const UInt32 level)
+{
+   for (void* entry : node->entries)
+   {
+      if (entry == nullptr)
+         continue;
+      if (level == m_levels - 1)
+         deleteChunk(static_cast<Byte*>(entry));
+      else
+         deleteNode(static_cast<Node*>(entry), level + 1);
+   }
+   delete node;
+}
+
+void
+DramDataArena::visitNode(const Node* node, const UInt32 level, const IntPtr base, const std::function<void(IntPtr, const Byte*)>& visit) const
+{
+   const UInt32 shift = m_chunk_bits + (m_levels - 1 - level) * RADIX_BITS;
+   for (UInt32 i = 0; i < RADIX_SIZE; i++)
+   {
+      if (node->entries[i] == nullptr)
+         continue;
+      const IntPtr address = base | (IntPtr(i) << shift);
+      if (level == m_levels - 1)
+         visit(address, static_cast<const Byte*>(node->entries[i]));
+      else
+         visitNode(static_cast<const Node*>(node->entries[i]), level + 1, address, visit);
+   }
+}
+
+void
+DramDataArena::forEachChunk(const std::function<void(IntPtr base, const Byte* data)>& visit) const
+{
+   visitNode(m_root, 0, 0, visit);
+}
+
+void
+DramDataArena::dump(const String& filename) const
+{
+   FILE* fp = fopen(filename.c_str(), "wb");
+   LOG_ASSERT_ERROR(fp != nullptr, "Could not open %s to dump the DRAM contents", filename.c_str());
+
+   SnapshotHeader header;
+   memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+   header.chunk_size = m_chunk_size;
+   header.num_chunks = m_num_chunks;
+   fwrite(&header, sizeof(header), 1, fp);
+
+   forEachChunk([&](const IntPtr base, const Byte* data)
+   {
+      const UInt64 address = base;
+      fwrite(&address, sizeof(address), 1, fp);
+      fwrite(data, m_chunk_size, 1, fp);
+   });
+
+   fclose(fp);
+}
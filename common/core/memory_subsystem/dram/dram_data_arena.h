@@ -0,0 +1,76 @@
+#ifndef __DRAM_DATA_ARENA_H
+#define __DRAM_DATA_ARENA_H
+
+#include "fixed_types.h"
+#include "lock.h"
+
+#include <functional>
+
+/**
+ * Functional contents of a DRAM controller: a sparse address space of fixed-size chunks (4 KB, 2 MB, ...)
+ * found through a radix table, allocated zeroed on first use.
+ *
+ * Chunks come from the heap or, with use_mmap, from anonymous mappings: the OS then zero-fills them lazily,
+ * hands out huge pages for 2 MB chunks when it can, and release() returns partial chunks with madvise.
+ *
+ * Snapshot file: SnapshotHeader, then for every allocated chunk its base address (UInt64) and its contents.
+ */
+class DramDataArena
+{
+   public:
+      struct SnapshotHeader
+      {
+         char magic[8];
+         UInt64 chunk_size;
+         UInt64 num_chunks;
+      };
+      static constexpr char SNAPSHOT_MAGIC[8] = { 'D', 'R', 'A', 'M', 'S', 'N', 'P', '1' };
+
+      DramDataArena(UInt64 chunk_size, bool use_mmap);
+      ~DramDataArena();
+
+      DramDataArena(const DramDataArena&) = delete;
+      DramDataArena& operator=(const DramDataArena&) = delete;
+
+      // Storage of [address, address + size), which must not cross a chunk boundary
+      Byte* get(IntPtr address, UInt32 size);
+      // Same without allocating, nullptr if the chunk was never written (it reads as zeros)
+      [[nodiscard]] const Byte* peek(IntPtr address, UInt32 size) const;
+      // Return the memory of [address, address + size) to the system, the range reads as zeros afterwards
+      void release(IntPtr address, UInt64 size);
+
+      void forEachChunk(const std::function<void(IntPtr base, const Byte* data)>& visit) const;
+      void dump(const String& filename) const;
+
+      [[nodiscard]] UInt64 getChunkSize() const { return m_chunk_size; }
+      UInt64* getNumChunks() { return &m_num_chunks; }
+
+   private:
+      static const UInt32 ADDRESS_BITS = 48;
+      static const UInt32 RADIX_BITS = 9;
+      static const UInt32 RADIX_SIZE = 1 << RADIX_BITS;
+
+      struct Node
+      {
+         void* entries[RADIX_SIZE]; // Child nodes, or chunks at the last level
+      };
+
+      const UInt64 m_chunk_size;
+      const UInt32 m_chunk_bits;
+      const UInt32 m_levels;
+      const bool m_use_mmap;
+      Node* m_root;
+      UInt64 m_num_chunks;
+      Lock m_lock; // Taken only to allocate
+
+      [[nodiscard]] UInt32 getIndex(IntPtr address, UInt32 level) const;
+      [[nodiscard]] Byte* findChunk(IntPtr address) const;
+      Byte* allocateChunk(IntPtr address);
+
+      Byte* newChunk() const;
+      void deleteChunk(Byte* chunk) const;
+      void deleteNode(Node* node, UInt32 level);
+      void visitNode(const Node* node, UInt32 level, IntPtr base, const std::function<void(IntPtr, const Byte*)>& visit) const;
+};
+
+#endif // __DRAM_DATA_ARENA_H
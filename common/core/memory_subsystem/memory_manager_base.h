@@ -74,6 +74,16 @@ class MemoryManagerBase
          return latency;
       }
 
+      // Functional warming of one cache line (InstMode::CACHE_ONLY): updates cache state only, no timing or statistics.
+      // Returns false when the access has to go through coreInitiateMemoryAccess instead.
+      virtual bool coreWarmMemoryAccess(
+            const bool icache,
+            const Core::mem_op_t mem_op_type,
+            const IntPtr address)
+      {
+         return false;
+      }
+
       virtual void handleMsgFromNetwork(NetPacket& packet) = 0;
 
       // FIXME: Take this out of here
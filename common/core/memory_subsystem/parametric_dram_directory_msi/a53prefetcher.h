@@ -15,7 +15,7 @@ class A53Prefetcher : public Prefetcher
 
 public:
    A53Prefetcher(String configName, core_id_t core_id);
-   std::vector<IntPtr> getNextAddress(IntPtr currentAddress, core_id_t core_id) override;
+   UInt32 getNextAddress(IntPtr currentAddress, IntPtr eip, core_id_t core_id, IntPtr *addresses, UInt32 max_addresses) override;
 };
 
 #endif // A53PREFETCHER_H
@@ -0,0 +1,101 @@
+#include "best_offset_prefetcher.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "log.h"
+
+#include <algorithm>
+
+static const IntPtr PAGE_SIZE = 4096;
+static const IntPtr PAGE_MASK = ~(PAGE_SIZE-1);
+
+BestOffsetPrefetcher::BestOffsetPrefetcher(String configName, core_id_t core_id)
+   : m_cache_block_size(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/cache_block_size", core_id))
+   , m_score_max(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/best_offset/score_max", core_id))
+   , m_round_max(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/best_offset/round_max", core_id))
+   , m_bad_score(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/best_offset/bad_score", core_id))
+   , m_degree(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/best_offset/degree", core_id))
+   , m_recent_requests(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/best_offset/rr_size", core_id), INVALID_ADDRESS)
+   , m_test_index(0)
+   , m_round(0)
+   , m_best_offset(1)
+   , m_enabled(true)
+{
+   UInt32 max_offset = Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/best_offset/max_offset", core_id);
+   for(UInt32 offset = 1; offset <= max_offset; ++offset)
+   {
+      UInt32 n = offset;
+      for(UInt32 factor : { 2, 3, 5 })
+         while (n % factor == 0)
+            n /= factor;
+      if (n == 1)
+         m_offsets.push_back(offset);
+   }
+   m_scores.resize(m_offsets.size(), 0);
+
+   LOG_ASSERT_ERROR(m_recent_requests.size() > 0, "perf_model/%s/prefetcher/best_offset/rr_size must be at least 1", configName.c_str());
+   LOG_ASSERT_ERROR(m_offsets.size() > 0, "perf_model/%s/prefetcher/best_offset/max_offset must be at least 1", configName.c_str());
+}
+
+bool
+BestOffsetPrefetcher::inRecentRequests(IntPtr line) const
+{
+   return m_recent_requests[(line ^ (line >> 8)) % m_recent_requests.size()] == line;
+}
+
+void
+BestOffsetPrefetcher::insertRecentRequest(IntPtr line)
+{
+   m_recent_requests[(line ^ (line >> 8)) % m_recent_requests.size()] = line;
+}
+
+void
+BestOffsetPrefetcher::endLearningPhase()
+{
+   UInt32 best = 0;
+   for(UInt32 i = 1; i < m_scores.size(); ++i)
+      if (m_scores[i] > m_scores[best])
+         best = i;
+
+   m_enabled = m_scores[best] > m_bad_score;
+   m_best_offset = m_offsets[best];
+
+   std::fill(m_scores.begin(), m_scores.end(), 0);
+   m_test_index = 0;
+   m_round = 0;
+}
+
+UInt32
+BestOffsetPrefetcher::getNextAddress(IntPtr current_address, IntPtr eip, core_id_t core_id, IntPtr *addresses, UInt32 max_addresses)
+{
+   IntPtr line = current_address / m_cache_block_size;
+
+   // Learning: test one offset per access
+   SInt64 offset = m_offsets[m_test_index];
+   if (inRecentRequests(line - offset) && ++m_scores[m_test_index] >= m_score_max)
+   {
+      endLearningPhase();
+   }
+   else if (++m_test_index == m_offsets.size())
+   {
+      m_test_index = 0;
+      if (++m_round == m_round_max)
+         endLearningPhase();
+   }
+
+   // Fill times are not tracked here: the prefetch of X + D counts as completed right away, so X is recorded
+   insertRecentRequest(line);
+
+   if (!m_enabled)
+      return 0;
+
+   UInt32 count = 0;
+   for(UInt32 i = 1; i <= m_degree && count < max_addresses; ++i)
+   {
+      IntPtr prefetch_address = (line + i * m_best_offset) * m_cache_block_size;
+      if ((prefetch_address & PAGE_MASK) != (current_address & PAGE_MASK))
+         break;
+      addresses[count++] = prefetch_address;
+   }
+
+   return count;
+}
@@ -0,0 +1,41 @@
+#ifndef __BEST_OFFSET_PREFETCHER_H
+#define __BEST_OFFSET_PREFETCHER_H
+
+#include "prefetcher.h"
+
+#include <vector>
+
+// Best-offset prefetcher (Michaud, HPCA 2016): prefetches line X + D on an access to line X, with D learned by
+// testing the candidate offsets (1..max_offset lines, prime factors 2, 3 and 5 only) one per access: offset d
+// scores when X - d is in the recent-requests table, i.e. a prefetch with offset d would have been in time.
+// A learning phase ends after round_max rounds over all offsets or when an offset reaches score_max, the best
+// offset is then used for the next phase, or prefetching is turned off if its score is at most bad_score.
+// Prefetches never cross a page boundary.
+class BestOffsetPrefetcher : public Prefetcher
+{
+   public:
+      BestOffsetPrefetcher(String configName, core_id_t core_id);
+      UInt32 getNextAddress(IntPtr current_address, IntPtr eip, core_id_t core_id, IntPtr *addresses, UInt32 max_addresses) override;
+
+   private:
+      const UInt32 m_cache_block_size;
+      const UInt32 m_score_max;
+      const UInt32 m_round_max;
+      const UInt32 m_bad_score;
+      const UInt32 m_degree;
+
+      std::vector<SInt64> m_offsets;
+      std::vector<UInt32> m_scores;
+      std::vector<IntPtr> m_recent_requests;  // Direct-mapped, line addresses
+
+      UInt32 m_test_index;
+      UInt32 m_round;
+      SInt64 m_best_offset;
+      bool m_enabled;        // The best offset scored above bad_score in the last learning phase
+
+      bool inRecentRequests(IntPtr line) const;
+      void insertRecentRequest(IntPtr line);
+      void endLearningPhase();
+};
+
+#endif // __BEST_OFFSET_PREFETCHER_H
@@ -67,12 +67,6 @@ const char * ReasonString(Transition::reason_t reason) {
    }
 }
 
-MshrEntry make_mshr(SubsecondTime t_issue, SubsecondTime t_complete) {
-   MshrEntry e;
-   e.t_issue = t_issue; e.t_complete = t_complete;
-   return e;
-}
-
 #ifdef ENABLE_TRACK_SHARING_PREVCACHES
 PrevCacheIndex CacheCntlrList::find(core_id_t core_id, MemComponent::component_t mem_component)
 {
@@ -117,6 +111,7 @@ CacheMasterCntlr::accessATDs(Core::mem_op_t mem_op_type, bool hit, IntPtr addres
 CacheMasterCntlr::~CacheMasterCntlr()
 {
    delete m_cache;
+   delete m_prefetcher;
    for(std::vector<ATD*>::iterator it = m_atds.begin(); it != m_atds.end(); ++it)
    {
       delete *it;
@@ -155,7 +150,10 @@ CacheCntlr::CacheCntlr(MemComponent::component_t mem_component,
    m_last_remote_hit_where(HitWhere::UNKNOWN),
    m_shmem_perf(new ShmemPerf()),
    m_shmem_perf_global(NULL),
-   m_shmem_perf_model(shmem_perf_model)
+   m_shmem_perf_model(shmem_perf_model),
+   m_profiled_lock(NULL),
+   m_setlock_acquires(0),
+   m_setlock_wait_time(0)
 {
    m_core_id_master = m_core_id - m_core_id % m_shared_cores;
    Sim()->getStatsManager()->logTopology(name, core_id, m_core_id_master);
@@ -197,6 +195,11 @@ CacheCntlr::CacheCntlr(MemComponent::component_t mem_component,
       }
 
       Sim()->getHooksManager()->registerHook(HookType::HOOK_ROI_END, __walkUsageBits, (UInt64)this, HooksManager::ORDER_NOTIFY_PRE);
+
+      // Average memory-level parallelism seen by the MSHR: mshr-occupancy / mshr-allocations
+      registerStatsMetric(name, core_id, "mshr-allocations", &m_master->m_mshr_allocations);
+      registerStatsMetric(name, core_id, "mshr-occupancy", &m_master->m_mshr_occupancy);
+      registerStatsMetric(name, core_id, "mshr-occupancy-max", &m_master->m_mshr_occupancy_max);
    }
    else
    {
@@ -232,6 +235,8 @@ CacheCntlr::CacheCntlr(MemComponent::component_t mem_component,
    registerStatsMetric(name, core_id, "hits-prefetch", &stats.hits_prefetch);
    registerStatsMetric(name, core_id, "evict-prefetch", &stats.evict_prefetch);
    registerStatsMetric(name, core_id, "invalidate-prefetch", &stats.invalidate_prefetch);
+   registerStatsMetric(name, core_id, "hits-prefetch-late", &stats.hits_prefetch_late);
+   registerStatsMetric(name, core_id, "prefetch-late-latency", &stats.prefetch_late_latency);
    registerStatsMetric(name, core_id, "hits-warmup", &stats.hits_warmup);
    registerStatsMetric(name, core_id, "evict-warmup", &stats.evict_warmup);
    registerStatsMetric(name, core_id, "invalidate-warmup", &stats.invalidate_warmup);
@@ -260,6 +265,15 @@ CacheCntlr::CacheCntlr(MemComponent::component_t mem_component,
    registerStatsMetric(name, core_id, "coherency-upgrades", &stats.coherency_upgrades);
    registerStatsMetric(name, core_id, "coherency-writebacks", &stats.coherency_writebacks);
    registerStatsMetric(name, core_id, "coherency-invalidates", &stats.coherency_invalidates);
+   if (Sim()->getCfg()->getBoolDefault("perf_model/cache/lock_profiling", false))
+   {
+      // Every controller waits on its own proxy, so a shared cache reports the waits of each of its cores
+      m_profiled_lock = new ProfiledLock(m_master->m_cache_lock);
+      registerStatsMetric(name, core_id, "lock-acquires", m_profiled_lock->getAcquires());
+      registerStatsMetric(name, core_id, "lock-wait-time", m_profiled_lock->getWaitTime());
+      registerStatsMetric(name, core_id, "setlock-acquires", &m_setlock_acquires);
+      registerStatsMetric(name, core_id, "setlock-wait-time", &m_setlock_wait_time);
+   }
 #ifdef ENABLE_TRANSITIONS
    for(CacheState::cstate_t old_state = CacheState::CSTATE_FIRST; old_state < CacheState::NUM_CSTATE_STATES; old_state = CacheState::cstate_t(int(old_state)+1))
       for(CacheState::cstate_t new_state = CacheState::CSTATE_FIRST; new_state < CacheState::NUM_CSTATE_STATES; new_state = CacheState::cstate_t(int(new_state)+1))
@@ -295,6 +309,7 @@ CacheCntlr::~CacheCntlr()
       delete m_master;
    }
    delete m_shmem_perf;
+   delete m_profiled_lock;
    if (m_shmem_perf_global)
       delete m_shmem_perf_global;
    #ifdef TRACK_LATENCY_BY_HITWHERE
@@ -395,9 +410,10 @@ LOG_ASSERT_ERROR(offset + data_length <= getCacheBlockSize(), "access until %u >
       cache_block_info = NULL;
    }
 
+   // The counters, the L1 MSHR model and the statistics of a first-level cache are only updated by its core,
+   // serialized with the sibling SMT threads by m_smt_lock: the hit path does not need the cache lock
    if (count)
    {
-      ScopedLock sl(getLock());
       // Update the Cache Counters
       getCache()->updateCounters(cache_hit);
       updateCounters(mem_op_type, ca_address, cache_hit, getCacheState(cache_block_info), Prefetch::NONE);
@@ -424,7 +440,6 @@ MYLOG("L1 hit");
 
       if (modeled && m_l1_mshr)
       {
-         ScopedLock sl(getLock());
          SubsecondTime t_now = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
          SubsecondTime t_completed = m_master->m_l1_mshr.getTagCompletionTime(ca_address);
          if (t_completed != SubsecondTime::MaxTime() && t_completed > t_now)
@@ -441,14 +456,18 @@ MYLOG("L1 hit");
 
       if (modeled)
       {
-         ScopedLock sl(getLock());
          // This is a hit, but maybe the prefetcher filled it at a future time stamp. If so, delay.
          SubsecondTime t_now = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
-         if (m_master->mshr.count(ca_address)
-            && (m_master->mshr[ca_address].t_issue < t_now && m_master->mshr[ca_address].t_complete > t_now))
+         SubsecondTime t_complete = getMshrCompletion(ca_address, t_now);
+         if (t_complete > t_now)
          {
-            SubsecondTime latency = m_master->mshr[ca_address].t_complete - t_now;
+            SubsecondTime latency = t_complete - t_now;
             stats.mshr_latency += latency;
+            if (prefetch_hit)
+            {
+               stats.hits_prefetch_late++;
+               stats.prefetch_late_latency += latency;
+            }
             getMemoryManager()->incrElapsedTime(latency, ShmemPerfModel::_USER_THREAD);
          }
       }
@@ -464,7 +483,6 @@ MYLOG("L1 miss");
 
       if (modeled && m_l1_mshr && !m_passthrough)
       {
-         ScopedLock sl(getLock());
          t_mshr_avail = m_master->m_l1_mshr.getStartTime(t_miss_begin);
          LOG_ASSERT_ERROR(t_mshr_avail >= t_miss_begin, "t_mshr_avail < t_miss_begin");
          SubsecondTime mshr_latency = t_mshr_avail - t_miss_begin;
@@ -489,7 +507,7 @@ MYLOG("L1 miss");
       }
 
 MYLOG("processMemOpFromCore l%d before next", m_mem_component);
-      hit_where = m_next_cache_cntlr->processShmemReqFromPrevCache(this, mem_op_type, ca_address, modeled, count, Prefetch::NONE, t_start, false);
+      hit_where = m_next_cache_cntlr->processShmemReqFromPrevCache(this, mem_op_type, ca_address, modeled, count, Prefetch::NONE, t_start, false, eip);
       bool next_cache_hit = hit_where != HitWhere::MISS;
 MYLOG("processMemOpFromCore l%d next hit = %d", m_mem_component, next_cache_hit);
 
@@ -516,7 +534,7 @@ MYLOG("processMemOpFromCore l%d got message reply", m_mem_component);
 
          /* have the next cache levels fill themselves with the new data */
 MYLOG("processMemOpFromCore l%d before next fill", m_mem_component);
-         hit_where = m_next_cache_cntlr->processShmemReqFromPrevCache(this, mem_op_type, ca_address, false, false, Prefetch::NONE, t_start, true);
+         hit_where = m_next_cache_cntlr->processShmemReqFromPrevCache(this, mem_op_type, ca_address, false, false, Prefetch::NONE, t_start, true, eip);
 MYLOG("processMemOpFromCore l%d after next fill", m_mem_component);
          LOG_ASSERT_ERROR(hit_where != HitWhere::MISS,
             "Tried to read in next-level cache, but data is already gone");
@@ -546,7 +564,6 @@ MYLOG("processMemOpFromCore l%d after next fill", m_mem_component);
       if (modeled && m_l1_mshr && !m_passthrough)
       {
          SubsecondTime t_miss_end = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
-         ScopedLock sl(getLock());
          m_master->m_l1_mshr.getCompletionTime(t_miss_begin, t_miss_end - t_mshr_avail, ca_address);
       }
    }
@@ -567,10 +584,8 @@ MYLOG("access done");
    SubsecondTime t_now = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
    SubsecondTime total_latency = t_now - t_start;
 
-   // From here on downwards: not long anymore, only stats update so blanket cntrl lock
+   // From here on downwards: not long anymore, only stats update
    {
-      ScopedLock sl(getLock());
-
       if (! cache_hit && count) {
          stats.total_latency += total_latency;
       }
@@ -601,7 +616,7 @@ MYLOG("access done");
 
    if (modeled && m_master->m_prefetcher)
    {
-       trainPrefetcher(ca_address, cache_hit, prefetch_hit, false, t_start);
+       trainPrefetcher(ca_address, eip, cache_hit, prefetch_hit, false, t_start);
    }
 
    // Call Prefetch on next-level caches (but not for atomic instructions as that causes a locking mess)
@@ -618,6 +633,80 @@ MYLOG("access done");
 }
 
 
+/*
+   Functional warming (InstMode::CACHE_ONLY): bring the line into this first-level cache with the permission the access needs,
+   updating only the tags, coherence states and replacement state of the hierarchy. No time is accounted, no statistics,
+   MSHRs or prefetchers are updated. The lines come from the first level of this node that can grant them without a coherence
+   action, through the usual fill path (copyDataFromNextLevel), so evictions, writebacks and the DONUTS epoch state behave
+   as in the detailed path. Returns false, without changing anything, when the directory or another cache would have to be
+   involved: the caller then does the access through processMemOpFromCore.
+*/
+bool
+CacheCntlr::warmMemOpFromCore(Core::mem_op_t mem_op_type, IntPtr ca_address)
+{
+   LOG_ASSERT_ERROR((ca_address & (getCacheBlockSize() - 1)) == 0, "address at cache line + %x", ca_address & (getCacheBlockSize() - 1));
+
+   if (m_perfect || m_passthrough || (m_cache_writethrough && mem_op_type == Core::WRITE))
+      return false;
+
+   ScopedLock sl_smt(m_master->m_smt_lock);
+   SubsecondTime t_now = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
+
+   acquireLock(ca_address);
+   if (operationPermissibleinCache(ca_address, mem_op_type))
+   {
+      accessCache(mem_op_type, ca_address, 0, NULL, 0, true);
+      releaseLock(ca_address);
+      return true;
+   }
+
+   // Miss: lock the complete stack for this set, as the detailed path does
+   acquireStackLock(ca_address, true);
+
+   bool done = false;
+   if (getCacheBlockInfo(ca_address) == NULL && m_next_cache_cntlr
+       && m_next_cache_cntlr->warmFromPrevCache(this, mem_op_type, ca_address, t_now))
+   {
+      copyDataFromNextLevel(mem_op_type, ca_address, false, t_now);
+      accessCache(mem_op_type, ca_address, 0, NULL, 0, true);
+      done = true;
+   }
+
+   releaseStackLock(ca_address, true);
+   releaseLock(ca_address);
+   return done;
+}
+
+bool
+CacheCntlr::warmFromPrevCache(CacheCntlr* requester, Core::mem_op_t mem_op_type, IntPtr address, SubsecondTime t_now)
+{
+   if (m_perfect || m_passthrough)
+      return false;
+
+   SharedCacheBlockInfo* cache_block_info = getCacheBlockInfo(address);
+   if (operationPermissibleinCache(address, mem_op_type))
+   {
+      // Reading a SHARED line never touches the other copies, anything else would downgrade or invalidate them
+      if (mem_op_type != Core::READ || cache_block_info->getCState() != CacheState::SHARED)
+      {
+         for (CacheCntlrList::iterator it = m_master->m_prev_cache_cntlrs.begin(); it != m_master->m_prev_cache_cntlrs.end(); it++)
+            if (*it != requester && (*it)->getCacheState(address) != CacheState::INVALID)
+               return false;
+      }
+      m_master->m_cache->accessSingleLine(address, Cache::LOAD, NULL, 0, t_now, true);
+      return true;
+   }
+
+   // Upgrades and last-level misses need the directory
+   if (cache_block_info || !m_next_cache_cntlr)
+      return false;
+
+   if (!m_next_cache_cntlr->warmFromPrevCache(this, mem_op_type, address, t_now))
+      return false;
+   copyDataFromNextLevel(mem_op_type, address, false, t_now);
+   return true;
+}
+
 void
 CacheCntlr::updateHits(Core::mem_op_t mem_op_type, UInt64 hits)
 {
@@ -673,17 +762,18 @@ MYLOG("copyDataFromNextLevel l%d", m_mem_component);
 }
 
 void
-CacheCntlr::trainPrefetcher(IntPtr address, bool cache_hit, bool prefetch_hit, bool prefetch_own, SubsecondTime t_issue)
+CacheCntlr::trainPrefetcher(IntPtr address, IntPtr eip, bool cache_hit, bool prefetch_hit, bool prefetch_own, SubsecondTime t_issue)
 {
    ScopedLock sl(getLock());
 
-   std::vector<IntPtr> prefetchList;
+   IntPtr prefetchList[Prefetcher::MAX_PREFETCHES];
+   UInt32 numPrefetches;
 
    bool prefetcherTrained;
 
    // Train the prefetcher always or only on misses on lines that are not being brought by the prefetcher (load or store miss)
    if (m_train_prefetcher_on_hit || (!prefetch_own && !cache_hit)) {
-      prefetchList = m_master->m_prefetcher->getNextAddress(address, m_core_id);
+      numPrefetches = m_master->m_prefetcher->getNextAddress(address, eip, m_core_id, prefetchList, Prefetcher::MAX_PREFETCHES);
       prefetcherTrained = true;
    }
    else prefetcherTrained = false;
@@ -696,13 +786,13 @@ CacheCntlr::trainPrefetcher(IntPtr address, bool cache_hit, bool prefetch_hit, b
       // Just talked to the next-level cache, wait a bit before we start to prefetch if enabled
       m_master->m_prefetch_next = m_prefetch_delay ? t_issue + PREFETCH_INTERVAL:t_issue;
 
-      for(std::vector<IntPtr>::iterator it = prefetchList.begin(); it != prefetchList.end(); ++it)
+      for(UInt32 i = 0; i < numPrefetches; ++i)
       {
          // Keep at most PREFETCH_MAX_QUEUE_LENGTH entries in the prefetch queue
-         if (m_master->m_prefetch_list.size() > PREFETCH_MAX_QUEUE_LENGTH)
+         if (m_master->m_prefetch_list.full())
             break;
-         if (!operationPermissibleinCache(*it, Core::READ)) {
-            m_master->m_prefetch_list.push_back(*it);
+         if (!operationPermissibleinCache(prefetchList[i], Core::READ)) {
+            m_master->m_prefetch_list.push(prefetchList[i]);
          }
       }
    }
@@ -720,8 +810,7 @@ CacheCntlr::Prefetch(SubsecondTime t_now)
       {
          while(!m_master->m_prefetch_list.empty())
          {
-            IntPtr address = m_master->m_prefetch_list.front();
-            m_master->m_prefetch_list.pop_front();
+            IntPtr address = m_master->m_prefetch_list.pop();
 
             // Check address again, maybe some other core already brought it into the cache
             if (!operationPermissibleinCache(address, Core::READ))
@@ -757,7 +846,7 @@ CacheCntlr::doPrefetch(IntPtr prefetch_address, SubsecondTime t_start)
    MYLOG("prefetching %lx", prefetch_address);
    SubsecondTime t_before = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
    getShmemPerfModel()->setElapsedTime(ShmemPerfModel::_USER_THREAD, t_start); // Start the prefetch at the same time as the original miss
-   HitWhere::where_t hit_where = processShmemReqFromPrevCache(this, Core::READ, prefetch_address, true, true, Prefetch::OWN, t_start, false);
+   HitWhere::where_t hit_where = processShmemReqFromPrevCache(this, Core::READ, prefetch_address, true, true, Prefetch::OWN, t_start, false, 0);
 
    if (hit_where == HitWhere::MISS)
    {
@@ -767,7 +856,7 @@ CacheCntlr::doPrefetch(IntPtr prefetch_address, SubsecondTime t_start)
       waitForNetworkThread();
       wakeUpNetworkThread();
 
-      hit_where = processShmemReqFromPrevCache(this, Core::READ, prefetch_address, false, false, Prefetch::OWN, t_start, false);
+      hit_where = processShmemReqFromPrevCache(this, Core::READ, prefetch_address, false, false, Prefetch::OWN, t_start, false, 0);
 
       LOG_ASSERT_ERROR(hit_where != HitWhere::MISS, "Line was not there after prefetch");
    }
@@ -782,7 +871,7 @@ CacheCntlr::doPrefetch(IntPtr prefetch_address, SubsecondTime t_start)
  *****************************************************************************/
 
 HitWhere::where_t
-CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t mem_op_type, IntPtr address, bool modeled, bool count, Prefetch::prefetch_type_t isPrefetch, SubsecondTime t_issue, bool have_write_lock)
+CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t mem_op_type, IntPtr address, bool modeled, bool count, Prefetch::prefetch_type_t isPrefetch, SubsecondTime t_issue, bool have_write_lock, IntPtr eip)
 {
    #ifdef PRIVATE_L2_OPTIMIZATION
    bool have_write_lock_internal = have_write_lock;
@@ -848,14 +937,18 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
          of the previous-level cache, not our (longer) access time */
       if (modeled)
       {
-         ScopedLock sl(getLock());
          // This is a hit, but maybe the prefetcher filled it at a future time stamp. If so, delay.
          SubsecondTime t_now = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
-         if (m_master->mshr.count(address)
-            && (m_master->mshr[address].t_issue < t_now && m_master->mshr[address].t_complete > t_now))
+         SubsecondTime t_complete = getMshrCompletion(address, t_now);
+         if (t_complete > t_now)
          {
-            SubsecondTime latency = m_master->mshr[address].t_complete - t_now;
+            SubsecondTime latency = t_complete - t_now;
             stats.mshr_latency += latency;
+            if (prefetch_hit)
+            {
+               stats.hits_prefetch_late++;
+               stats.prefetch_late_latency += latency;
+            }
             getMemoryManager()->incrElapsedTime(latency, ShmemPerfModel::_USER_THREAD);
          }
          else
@@ -954,7 +1047,7 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
             invalidateCacheBlock(address);
 
          // let the next cache level handle it.
-         hit_where = m_next_cache_cntlr->processShmemReqFromPrevCache(this, mem_op_type, address, modeled, count, isPrefetch == Prefetch::NONE ? Prefetch::NONE : Prefetch::OTHER, t_issue, have_write_lock_internal);
+         hit_where = m_next_cache_cntlr->processShmemReqFromPrevCache(this, mem_op_type, address, modeled, count, isPrefetch == Prefetch::NONE ? Prefetch::NONE : Prefetch::OTHER, t_issue, have_write_lock_internal, eip);
          if (hit_where != HitWhere::MISS)
          {
             cache_hit = true;
@@ -1030,15 +1123,13 @@ CacheCntlr::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t m
       /* Store completion time so we can detect overlapping accesses */
       if (modeled && !first_hit && !m_passthrough)
       {
-         ScopedLock sl(getLock());
-         m_master->mshr[address] = make_mshr(t_issue, getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD));
-         cleanupMshr();
+         insertMshr(address, t_issue, getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD));
       }
    }
 
    if (modeled && m_master->m_prefetcher)
    {
-      trainPrefetcher(address, cache_hit, prefetch_hit, isPrefetch == Prefetch::prefetch_type_t::OWN, t_issue);
+      trainPrefetcher(address, eip, cache_hit, prefetch_hit, isPrefetch == Prefetch::prefetch_type_t::OWN, t_issue);
    }
 
    #ifdef PRIVATE_L2_OPTIMIZATION
@@ -1877,11 +1968,7 @@ MYLOG("wakeup user #%u", request->cache_cntlr->m_core_id);
          waitForUserThread(request->cache_cntlr->m_network_thread_sem);
          acquireStackLock(address);
 
-         {
-            ScopedLock sl(request->cache_cntlr->getLock());
-            request->cache_cntlr->m_master->mshr[address] = make_mshr(request->t_issue, getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_SIM_THREAD));
-            cleanupMshr();
-         }
+         request->cache_cntlr->insertMshr(address, request->t_issue, getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_SIM_THREAD));
 
          getLock().acquire();
          MYLOG("about to dequeue request (%p) for address %lx", m_master->m_directory_waiters.front(address), address );
@@ -2087,7 +2174,7 @@ CacheCntlr::updateCounters(Core::mem_op_t mem_op_type, IntPtr address, bool cach
       operationPermissibleinCache() will think it's a hit (so cache_hit == true) since the processing
       of the previous miss was done instantaneously. But mshr[address] contains its completion time */
    SubsecondTime t_now = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
-   bool overlapping = m_master->mshr.count(address) && m_master->mshr[address].t_issue < t_now && m_master->mshr[address].t_complete > t_now;
+   bool overlapping = getMshrCompletion(address, t_now) > t_now;
 
    // ATD doesn't track state, so when reporting hit/miss to it we shouldn't either (i.e. write hit to shared line becomes hit, not miss)
    bool cache_data_hit = (state != CacheState::INVALID);
@@ -2124,8 +2211,6 @@ CacheCntlr::updateCounters(Core::mem_op_t mem_op_type, IntPtr address, bool cach
       }
    }
 
-   cleanupMshr();
-
    #ifdef ENABLE_TRANSITIONS
    transition(
       address,
@@ -2137,20 +2222,24 @@ CacheCntlr::updateCounters(Core::mem_op_t mem_op_type, IntPtr address, bool cach
 }
 
 void
-CacheCntlr::cleanupMshr()
-{
-   /* Keep only last 8 MSHR entries */
-   while(m_master->mshr.size() > 8) {
-      IntPtr address_min = 0;
-      SubsecondTime time_min = SubsecondTime::MaxTime();
-      for(Mshr::iterator it = m_master->mshr.begin(); it != m_master->mshr.end(); ++it) {
-         if (it->second.t_complete < time_min) {
-            address_min = it->first;
-            time_min = it->second.t_complete;
-         }
-      }
-      m_master->mshr.erase(address_min);
-   }
+CacheCntlr::insertMshr(IntPtr address, SubsecondTime t_issue, SubsecondTime t_complete)
+{
+   ScopedLock sl(m_master->m_mshr_lock);
+   UInt32 in_flight = m_master->mshr.insert(address, t_issue, t_complete);
+   m_master->m_mshr_allocations++;
+   m_master->m_mshr_occupancy += in_flight;
+   m_master->m_mshr_occupancy_max = std::max<UInt64>(m_master->m_mshr_occupancy_max, in_flight);
+}
+
+/* Completion time of a miss to address still in progress at t_now, Zero if there is none */
+SubsecondTime
+CacheCntlr::getMshrCompletion(IntPtr address, SubsecondTime t_now)
+{
+   ScopedLock sl(m_master->m_mshr_lock);
+   const MshrEntry* entry = m_master->mshr.find(address);
+   if (entry && entry->t_issue < t_now && entry->t_complete > t_now)
+      return entry->t_complete;
+   return SubsecondTime::Zero();
 }
 
 void
@@ -2215,6 +2304,10 @@ CacheCntlr::updateUncoreStatistics(HitWhere::where_t hit_where, SubsecondTime no
 
    Additionally, for per-cache objects that are not private to a cache set, each cache controller has its own (normal) lock,
    use getLock() for this. This is required for statistics updates, the directory waiters queue, etc.
+   The first level does not take it on its access path: its statistics are only updated by its own core.
+   The MSHR has its own leaf lock (m_mshr_lock), so looking up an outstanding miss does not take the cache lock either.
+
+   With perf_model/cache/lock_profiling, every controller reports the host time it waits for the cache lock and the set locks.
 */
 
 void
@@ -2222,8 +2315,11 @@ CacheCntlr::acquireLock(UInt64 address)
 {
 MYLOG("cache lock acquire %u # %u @ %lx", m_mem_component, m_core_id, address);
    assert(isFirstLevel());
+   const UInt64 t_start = m_profiled_lock ? Timer::now() : 0;
    // Lock this L1 cache for the set containing <address>.
    lastLevelCache()->m_master->getSetLock(address)->acquire_shared(m_core_id);
+   if (m_profiled_lock)
+      accountSetLock(t_start);
 }
 
 void
@@ -2238,6 +2334,7 @@ void
 CacheCntlr::acquireStackLock(UInt64 address, bool this_is_locked)
 {
 MYLOG("stack lock acquire %u # %u @ %lx", m_mem_component, m_core_id, address);
+   const UInt64 t_start = m_profiled_lock ? Timer::now() : 0;
    // Lock the complete stack for the set containing <address>
    if (this_is_locked)
       // If two threads decide to upgrade at the same time, we could deadlock.
@@ -2245,6 +2342,15 @@ MYLOG("stack lock acquire %u # %u @ %lx", m_mem_component, m_core_id, address);
       lastLevelCache()->m_master->getSetLock(address)->upgrade(m_core_id);
    else
       lastLevelCache()->m_master->getSetLock(address)->acquire_exclusive();
+   if (m_profiled_lock)
+      accountSetLock(t_start);
+}
+
+void
+CacheCntlr::accountSetLock(UInt64 t_start)
+{
+   __sync_fetch_and_add(&m_setlock_acquires, 1);
+   __sync_fetch_and_add(&m_setlock_wait_time, Timer::now() - t_start);
 }
 
 void
@@ -2350,8 +2456,7 @@ CacheCntlr *CacheCntlr::create(MemComponent::component_t mem_component,
    if (Sim()->getProjectType() == ProjectType::DONUTS)
    {
       return new CacheCntlrDonuts(mem_component, name, core_id, memory_manager, tag_directory_home_lookup, user_thread_sem,
-                                  network_thread_sem, cache_block_size, cache_params, shmem_perf_model, is_last_level_cache,
-                                  Sim()->getEpochManager().value().getEpochCntlr(core_id));
+                                  network_thread_sem, cache_block_size, cache_params, shmem_perf_model, is_last_level_cache);
    }
 
    return new CacheCntlr(mem_component, name, core_id, memory_manager, tag_directory_home_lookup, user_thread_sem,
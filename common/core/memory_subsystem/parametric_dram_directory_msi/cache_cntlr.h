@@ -9,11 +9,14 @@
 #include "mem_component.h"
 #include "semaphore.h"
 #include "lock.h"
+#include "profiled_lock.h"
 #include "setlock.h"
 #include "fixed_types.h"
 #include "shmem_perf_model.h"
 #include "contention_model.h"
 #include "req_queue_list_template.h"
+#include "mshr_table.h"
+#include "circular_queue.h"
 #include "stats.h"
 #include "subsecond_time.h"
 #include "shmem_perf.h"
@@ -141,23 +144,24 @@ namespace ParametricDramDirectoryMSI
 
    typedef ReqQueueListTemplate<CacheDirectoryWaiter> CacheDirectoryWaiterMap;
 
-   struct MshrEntry {
-      SubsecondTime t_issue, t_complete;
-   };
-   typedef std::unordered_map<IntPtr, MshrEntry> Mshr;
-
    class CacheMasterCntlr
    {
       private:
+         static const UInt32 MSHR_MIN_ENTRIES = 8; //< MSHR entries kept when the outstanding misses are not limited
+
          Cache* m_cache;
          Lock m_cache_lock;
          Lock m_smt_lock; //< Only used in L1 cache, to protect against concurrent access from sibling SMT threads
+         Lock m_mshr_lock; //< Protects mshr only, never held while taking another lock
          CacheCntlrList m_prev_cache_cntlrs;
          Prefetcher* m_prefetcher;
          DramCntlrInterface* m_dram_cntlr;
          ContentionModel* m_dram_outstanding_writebacks;
 
-         Mshr mshr;
+         MshrTable mshr;
+         UInt64 m_mshr_allocations;
+         UInt64 m_mshr_occupancy;      //< Sum over the allocations of the misses in flight, this one included
+         UInt64 m_mshr_occupancy_max;
          ContentionModel m_l1_mshr;
          ContentionModel m_next_level_read_bandwidth;
          CacheDirectoryWaiterMap m_directory_waiters;
@@ -170,7 +174,7 @@ namespace ParametricDramDirectoryMSI
          UInt32 m_log_blocksize;
          UInt32 m_num_sets;
 
-         std::deque<IntPtr> m_prefetch_list;
+         CircularQueue<IntPtr> m_prefetch_list; //< Addresses still to prefetch, at most PREFETCH_MAX_QUEUE_LENGTH
          SubsecondTime m_prefetch_next;
 
          void createSetLocks(UInt32 cache_block_size, UInt32 num_sets, UInt32 core_offset, UInt32 num_cores);
@@ -185,6 +189,10 @@ namespace ParametricDramDirectoryMSI
             , m_prefetcher(NULL)
             , m_dram_cntlr(NULL)
             , m_dram_outstanding_writebacks(NULL)
+            , mshr(std::max<UInt32>(outstanding_misses, MSHR_MIN_ENTRIES))
+            , m_mshr_allocations(0)
+            , m_mshr_occupancy(0)
+            , m_mshr_occupancy_max(0)
             , m_l1_mshr(name + ".mshr", core_id, outstanding_misses)
             , m_next_level_read_bandwidth(name + ".next_read", core_id)
             , m_evicting_address(0)
@@ -192,7 +200,7 @@ namespace ParametricDramDirectoryMSI
             , m_atds()
             , m_log_blocksize(0)
             , m_num_sets(0)
-            , m_prefetch_list()
+            , m_prefetch_list(PREFETCH_MAX_QUEUE_LENGTH)
             , m_prefetch_next(SubsecondTime::Zero())
          {}
          ~CacheMasterCntlr();
@@ -211,7 +219,6 @@ namespace ParametricDramDirectoryMSI
          CacheCntlr* m_next_cache_cntlr;
          CacheCntlr* m_last_level;
          AddressHomeLookup* m_tag_directory_home_lookup;
-         std::unordered_map<IntPtr, MemComponent::component_t> m_shmem_req_source_map;
          bool m_perfect;
          bool m_passthrough;
          bool m_coherent;
@@ -235,6 +242,8 @@ namespace ParametricDramDirectoryMSI
                   // some may still be in the cache, or could have been removed for some other reason.
                   // Also, in a shared cache, the prefetch may have been triggered by another core than the one
                   // accessing/evicting the line so *_prefetch statistics should be summed across the shared cache
+           UInt64 hits_prefetch_late; // hits_prefetch that still had to wait for the prefetch to complete
+           SubsecondTime prefetch_late_latency;
            UInt64 evict[CacheState::NUM_CSTATE_STATES];
            UInt64 backinval[CacheState::NUM_CSTATE_STATES];
            UInt64 hits_warmup, evict_warmup, invalidate_warmup;
@@ -255,7 +264,8 @@ namespace ParametricDramDirectoryMSI
          #endif
 
          void updateCounters(Core::mem_op_t mem_op_type, IntPtr address, bool cache_hit, CacheState::cstate_t state, Prefetch::prefetch_type_t isPrefetch);
-         void cleanupMshr();
+         void insertMshr(IntPtr address, SubsecondTime t_issue, SubsecondTime t_complete);
+         SubsecondTime getMshrCompletion(IntPtr address, SubsecondTime t_now);
          void transition(IntPtr address, Transition::reason_t reason, CacheState::cstate_t old_state, CacheState::cstate_t new_state);
          void updateUncoreStatistics(HitWhere::where_t hit_where, SubsecondTime now);
 
@@ -280,6 +290,11 @@ namespace ParametricDramDirectoryMSI
 
          ShmemPerfModel* m_shmem_perf_model;
 
+         // Contention profiling (perf_model/cache/lock_profiling): host time this controller waits for its locks
+         ProfiledLock* m_profiled_lock;
+         UInt64 m_setlock_acquires;
+         UInt64 m_setlock_wait_time;
+
          // Core-interfacing stuff
          void accessCache(
                Core::mem_op_t mem_op_type,
@@ -289,7 +304,7 @@ namespace ParametricDramDirectoryMSI
                IntPtr address, Core::mem_op_t mem_op_type, CacheBlockInfo **cache_block_info = NULL);
 
          void copyDataFromNextLevel(Core::mem_op_t mem_op_type, IntPtr address, bool modeled, SubsecondTime t_start);
-         void trainPrefetcher(IntPtr address, bool cache_hit, bool prefetch_hit, bool prefetch_own, SubsecondTime t_issue);
+         void trainPrefetcher(IntPtr address, IntPtr eip, bool cache_hit, bool prefetch_hit, bool prefetch_own, SubsecondTime t_issue);
          void Prefetch(SubsecondTime t_start);
          void doPrefetch(IntPtr prefetch_address, SubsecondTime t_start);
 
@@ -310,8 +325,11 @@ namespace ParametricDramDirectoryMSI
          // Modified by Kleber Kruger (added arg: eid)
          void writeCacheBlock(IntPtr address, UInt32 offset, Byte* data_buf, UInt32 data_length, ShmemPerfModel::Thread_t thread_num, UInt64 eid);
 
-         // Handle Request from previous level cache
-         HitWhere::where_t processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t mem_op_type, IntPtr address, bool modeled, bool count, Prefetch::prefetch_type_t isPrefetch, SubsecondTime t_issue, bool have_write_lock);
+         // Handle Request from previous level cache (virtual: DONUTS delays writes to lines still being persisted).
+         // eip is the instruction of the original core access (0 for prefetches), it trains the prefetcher of this level.
+         virtual HitWhere::where_t processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t mem_op_type, IntPtr address, bool modeled, bool count, Prefetch::prefetch_type_t isPrefetch, SubsecondTime t_issue, bool have_write_lock, IntPtr eip);
+         // Functional warming of a previous-level miss, false if it needs a coherence action (caller holds the stack lock)
+         bool warmFromPrevCache(CacheCntlr* requester, Core::mem_op_t mem_op_type, IntPtr address, SubsecondTime t_now);
 
          // Process Request from L1 Cache
          boost::tuple<HitWhere::where_t, SubsecondTime> accessDRAM(Core::mem_op_t mem_op_type, IntPtr address, bool isPrefetch, Byte* data_buf);
@@ -372,7 +390,7 @@ namespace ParametricDramDirectoryMSI
          virtual ~CacheCntlr();
 
          Cache* getCache() const { return m_master->m_cache; }
-         Lock& getLock() const { return m_master->m_cache_lock; }
+         BaseLock& getLock() const { return m_profiled_lock ? *static_cast<BaseLock*>(m_profiled_lock) : m_master->m_cache_lock; }
 
          void setPrevCacheCntlrs(CacheCntlrList& prev_cache_cntlrs);
          void setNextCacheCntlr(CacheCntlr* next_cache_cntlr) { m_next_cache_cntlr = next_cache_cntlr; }
@@ -388,6 +406,8 @@ namespace ParametricDramDirectoryMSI
                bool count,
                IntPtr eip); // Added by Kleber Kruger
          void updateHits(Core::mem_op_t mem_op_type, UInt64 hits);
+         // Functional warming of the line, false if it must go through processMemOpFromCore
+         bool warmMemOpFromCore(Core::mem_op_t mem_op_type, IntPtr ca_address);
 
          // Notify next level cache of so it can update its sharing set
          void notifyPrevLevelInsert(core_id_t core_id, MemComponent::component_t mem_component, IntPtr address);
@@ -398,6 +418,7 @@ namespace ParametricDramDirectoryMSI
          // Acquiring and Releasing per-set Locks
          void acquireLock(UInt64 address);
          void releaseLock(UInt64 address);
+         void accountSetLock(UInt64 t_start);
          void acquireStackLock(UInt64 address, bool this_is_locked = false);
          void releaseStackLock(UInt64 address, bool this_is_locked = false);
 
@@ -22,16 +22,16 @@ GhbPrefetcher::~GhbPrefetcher()
 {
 }
 
-std::vector<IntPtr>
-GhbPrefetcher::getNextAddress(IntPtr currentAddress, core_id_t core_id)
+UInt32
+GhbPrefetcher::getNextAddress(IntPtr currentAddress, IntPtr eip, core_id_t core_id, IntPtr *addresses, UInt32 max_addresses)
 {
-   std::vector<IntPtr> prefetchList;
+   UInt32 count = 0;
 
    //deal with prefether initialization
    if (m_lastAddress == INVALID_ADDRESS)
    {
       m_lastAddress = currentAddress;
-      return prefetchList;
+      return count;
    }
 
    //determine the delta with the last address
@@ -64,8 +64,8 @@ GhbPrefetcher::getNextAddress(IntPtr currentAddress, core_id_t core_id)
             newAddress += m_ghb[(ghbIndex + depth)%m_ghbSize].delta;
 
             //add address to the list if it wasn't in there already
-            if (find(prefetchList.begin(), prefetchList.end(), newAddress) == prefetchList.end())
-               prefetchList.push_back(newAddress);
+            if (count < max_addresses && std::find(addresses, addresses + count, newAddress) == addresses + count)
+               addresses[count++] = newAddress;
 
             ++depth;
          }
@@ -133,5 +133,5 @@ GhbPrefetcher::getNextAddress(IntPtr currentAddress, core_id_t core_id)
       m_generation = (m_generation + 1) % 4;
    }
 
-   return prefetchList;
+   return count;
 }
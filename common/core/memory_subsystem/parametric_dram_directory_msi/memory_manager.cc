@@ -43,7 +43,8 @@ MemoryManager::MemoryManager(Core* core,
    m_tlb_miss_parallel(false),
    m_tag_directory_present(false),
    m_dram_cntlr_present(false),
-   m_enabled(false)
+   m_enabled(false),
+   m_shmem_msg_pool(nullptr)
 {
    // Read Parameters from the Config file
    std::map<MemComponent::component_t, CacheParameters> cache_parameters;
@@ -368,6 +369,8 @@ MemoryManager::MemoryManager(Core* core,
       }
    }
 
+   m_shmem_msg_pool = new PrL1PrL2DramDirectoryMSI::ShmemMsgPool(m_cache_block_size);
+
    // Register Call-backs
    getNetwork()->registerCallback(SHARED_MEM_1, MemoryManagerNetworkCallback, this);
 
@@ -408,6 +411,9 @@ MemoryManager::~MemoryManager()
    delete m_dram_cache;
    delete m_dram_cntlr;
    delete m_dram_directory_cntlr;
+   // Messages sent by this node may still be in flight, the pool lives on until they are released
+   if (m_shmem_msg_pool)
+      m_shmem_msg_pool->destroy();
 }
 
 HitWhere::where_t
@@ -438,12 +444,30 @@ MemoryManager::coreInitiateMemoryAccess(
          eip); // Modified by Kleber Kruger | added arg: eip
 }
 
+bool
+MemoryManager::coreWarmMemoryAccess(
+      const bool icache,
+      const Core::mem_op_t mem_op_type,
+      const IntPtr address)
+{
+   if (!m_cache_cntlrs[icache ? MemComponent::L1_ICACHE : MemComponent::L1_DCACHE]->warmMemOpFromCore(mem_op_type, address))
+      return false;
+
+   TLB *tlb = icache ? m_itlb : m_dtlb;
+   if (tlb)
+      accessTLB(tlb, address, icache, Core::MEM_MODELED_NONE);
+   return true;
+}
+
 void
 MemoryManager::handleMsgFromNetwork(NetPacket& packet)
 {
 MYLOG("begin");
    core_id_t sender = packet.sender;
-   PrL1PrL2DramDirectoryMSI::ShmemMsg* shmem_msg = PrL1PrL2DramDirectoryMSI::ShmemMsg::getShmemMsg((Byte*) packet.data, &m_dummy_shmem_perf);
+   // Unicast messages arrive by pointer and are ours to release, broadcasts are serialized
+   PrL1PrL2DramDirectoryMSI::ShmemMsg* shmem_msg = packet.zero_copy
+      ? (PrL1PrL2DramDirectoryMSI::ShmemMsg*) packet.data
+      : PrL1PrL2DramDirectoryMSI::ShmemMsg::getShmemMsg((Byte*) packet.data, &m_dummy_shmem_perf);
    SubsecondTime msg_time = packet.time;
 
    getShmemPerfModel()->setElapsedTime(ShmemPerfModel::_SIM_THREAD, msg_time);
@@ -524,12 +548,19 @@ MYLOG("begin");
    // First delete 'data_buf' if it is present
    // LOG_PRINT("Finished handling Shmem Msg");
 
-   if (shmem_msg->getDataLength() > 0)
+   if (packet.zero_copy)
+   {
+      PrL1PrL2DramDirectoryMSI::ShmemMsgPool::release(shmem_msg);
+   }
+   else
    {
-      assert(shmem_msg->getDataBuf());
-      delete [] shmem_msg->getDataBuf();
+      if (shmem_msg->getDataLength() > 0)
+      {
+         assert(shmem_msg->getDataBuf());
+         delete [] shmem_msg->getDataBuf();
+      }
+      delete shmem_msg;
    }
-   delete shmem_msg;
 MYLOG("end");
 }
 
@@ -541,7 +572,8 @@ MYLOG("send msg %u %ul%u > %ul%u", msg_type, requester, sender_mem_component, re
    PrL1PrL2DramDirectoryMSI::ShmemMsg shmem_msg(msg_type, sender_mem_component, receiver_mem_component, requester, address, data_buf, data_length, perf);
    shmem_msg.setWhere(where);
 
-   Byte* msg_buf = shmem_msg.makeMsgBuf();
+   // Hand a pooled copy over to the receiver instead of serializing the message
+   PrL1PrL2DramDirectoryMSI::ShmemMsg* pooled_msg = m_shmem_msg_pool->create(shmem_msg);
    SubsecondTime msg_time = getShmemPerfModel()->getElapsedTime(thread_num);
    perf->updateTime(msg_time);
 
@@ -552,11 +584,9 @@ MYLOG("send msg %u %ul%u > %ul%u", msg_type, requester, sender_mem_component, re
 
    NetPacket packet(msg_time, SHARED_MEM_1,
          m_core_id_master, receiver,
-         shmem_msg.getMsgLen(), (const void*) msg_buf);
+         shmem_msg.getMsgLen(), (const void*) pooled_msg);
+   packet.zero_copy = true;
    getNetwork()->netSend(packet);
-
-   // Delete the Msg Buf
-   delete [] msg_buf;
 }
 
 void
@@ -7,6 +7,7 @@
 #include "../pr_l1_pr_l2_dram_directory_msi/dram_cntlr.h"
 #include "address_home_lookup.h"
 #include "../pr_l1_pr_l2_dram_directory_msi/shmem_msg.h"
+#include "../pr_l1_pr_l2_dram_directory_msi/shmem_msg_pool.h"
 #include "mem_component.h"
 #include "semaphore.h"
 #include "fixed_types.h"
@@ -53,6 +54,7 @@ namespace ParametricDramDirectoryMSI
          bool m_enabled;
 
          ShmemPerf m_dummy_shmem_perf;
+         PrL1PrL2DramDirectoryMSI::ShmemMsgPool* m_shmem_msg_pool; // Messages sent to a single receiver
 
          // Performance Models
          CachePerfModel* m_cache_perf_models[MemComponent::LAST_LEVEL_CACHE + 1];
@@ -91,6 +93,8 @@ namespace ParametricDramDirectoryMSI
                Core::MemModeled modeled,
                IntPtr eip) override; // Added by Kleber Kruger
 
+         bool coreWarmMemoryAccess(bool icache, Core::mem_op_t mem_op_type, IntPtr address) override;
+
          void handleMsgFromNetwork(NetPacket& packet) override;
 
          void sendMsg(PrL1PrL2DramDirectoryMSI::ShmemMsg::msg_t msg_type, MemComponent::component_t sender_mem_component, MemComponent::component_t receiver_mem_component, core_id_t requester, core_id_t receiver, IntPtr address, Byte* data_buf = nullptr, UInt32 data_length = 0, HitWhere::where_t where = HitWhere::UNKNOWN, ShmemPerf *perf = nullptr, ShmemPerfModel::Thread_t thread_num = ShmemPerfModel::NUM_CORE_THREADS) override;
@@ -0,0 +1,104 @@
+#include "mshr_table.h"
+#include "log.h"
+#include "utils.h"
+
+namespace ParametricDramDirectoryMSI
+{
+
+MshrTable::MshrTable(UInt32 capacity)
+   : m_capacity(capacity)
+   , m_size(0)
+{
+   LOG_ASSERT_ERROR(capacity > 0, "MSHR capacity must be at least 1");
+
+   UInt32 num_slots = 2;
+   while (num_slots < 2 * capacity)
+      num_slots <<= 1;
+
+   m_slots.resize(num_slots, Slot{0, {SubsecondTime::Zero(), SubsecondTime::Zero()}, false});
+   m_mask = num_slots - 1;
+   m_shift = 64 - floorLog2(num_slots);
+}
+
+UInt32
+MshrTable::probe(IntPtr address) const
+{
+   UInt32 index = home(address);
+   while (m_slots[index].used && m_slots[index].address != address)
+      index = (index + 1) & m_mask;
+   return index;
+}
+
+const MshrEntry*
+MshrTable::find(IntPtr address) const
+{
+   const Slot& slot = m_slots[probe(address)];
+   return slot.used ? &slot.entry : NULL;
+}
+
+UInt32
+MshrTable::insert(IntPtr address, SubsecondTime t_issue, SubsecondTime t_complete)
+{
+   UInt32 index = probe(address);
+   if (!m_slots[index].used)
+   {
+      if (m_size == m_capacity)
+      {
+         // Drop the miss that completes first
+         UInt32 oldest = 0;
+         SubsecondTime t_oldest = SubsecondTime::MaxTime();
+         for (UInt32 i = 0; i < m_slots.size(); i++)
+         {
+            if (m_slots[i].used && m_slots[i].entry.t_complete < t_oldest)
+            {
+               oldest = i;
+               t_oldest = m_slots[i].entry.t_complete;
+            }
+         }
+         erase(oldest);
+         index = probe(address);
+      }
+      m_slots[index].used = true;
+      m_slots[index].address = address;
+      m_size++;
+   }
+   m_slots[index].entry.t_issue = t_issue;
+   m_slots[index].entry.t_complete = t_complete;
+
+   UInt32 in_flight = 0;
+   for (const Slot& slot : m_slots)
+   {
+      if (slot.used && slot.entry.t_issue <= t_issue && slot.entry.t_complete > t_issue)
+         in_flight++;
+   }
+   return in_flight;
+}
+
+void
+MshrTable::erase(UInt32 index)
+{
+   // Move back the entries of the probe sequence that would no longer be reachable
+   UInt32 next = index;
+   while (true)
+   {
+      m_slots[index].used = false;
+      while (true)
+      {
+         next = (next + 1) & m_mask;
+         if (!m_slots[next].used)
+         {
+            m_size--;
+            return;
+         }
+         const UInt32 h = home(m_slots[next].address);
+         // The entry stays if its home lies cyclically in (index, next]
+         const bool stays = index <= next ? (index < h && h <= next) : (index < h || h <= next);
+         if (!stays)
+            break;
+      }
+      m_slots[index] = m_slots[next];
+      index = next;
+   }
+}
+
+}
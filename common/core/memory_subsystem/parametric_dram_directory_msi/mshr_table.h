@@ -0,0 +1,50 @@
+#pragma once
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+
+#include <vector>
+
+namespace ParametricDramDirectoryMSI
+{
+   struct MshrEntry {
+      SubsecondTime t_issue, t_complete;
+   };
+
+   /**
+    * Recent misses of a cache with their completion time, used to detect accesses that overlap a miss in progress.
+    *
+    * Fixed-capacity open-addressing table (linear probing, backward-shift deletion), so the miss path never allocates.
+    * When the table is full, the miss that completes first is dropped: it is the first one to stop overlapping.
+    */
+   class MshrTable
+   {
+      public:
+         explicit MshrTable(UInt32 capacity);
+
+         // Insert or update the miss to address, returns the number of misses in flight at t_issue (this one included)
+         UInt32 insert(IntPtr address, SubsecondTime t_issue, SubsecondTime t_complete);
+         [[nodiscard]] const MshrEntry* find(IntPtr address) const;
+
+         [[nodiscard]] UInt32 size() const { return m_size; }
+         [[nodiscard]] UInt32 getCapacity() const { return m_capacity; }
+
+      private:
+         struct Slot {
+            IntPtr address;
+            MshrEntry entry;
+            bool used;
+         };
+
+         const UInt32 m_capacity;
+         std::vector<Slot> m_slots;   // Power of two, at least twice the capacity to keep the probe sequences short
+         UInt32 m_mask;
+         UInt32 m_shift;
+         UInt32 m_size;
+
+         [[nodiscard]] UInt32 home(IntPtr address) const { return (address * 0x9E3779B97F4A7C15ULL) >> m_shift; }
+         // Slot holding address, or the free slot ending its probe sequence
+         [[nodiscard]] UInt32 probe(IntPtr address) const;
+         void erase(UInt32 index);
+   };
+}
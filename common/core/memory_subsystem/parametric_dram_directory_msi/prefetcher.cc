@@ -5,6 +5,8 @@
 #include "simple_prefetcher.h"
 #include "ghb_prefetcher.h"
 #include "a53prefetcher.h"
+#include "stride_prefetcher.h"
+#include "best_offset_prefetcher.h"
 
 Prefetcher* Prefetcher::createPrefetcher(String type, String configName, core_id_t core_id, UInt32 shared_cores)
 {
@@ -16,6 +18,10 @@ Prefetcher* Prefetcher::createPrefetcher(String type, String configName, core_id
       return new GhbPrefetcher(configName, core_id);
    else if (type == "a53prefetcher")
        return new A53Prefetcher(configName, core_id);
+   else if (type == "stride")
+      return new StridePrefetcher(configName, core_id);
+   else if (type == "best_offset")
+      return new BestOffsetPrefetcher(configName, core_id);
 
    LOG_PRINT_ERROR("Invalid prefetcher type %s", type.c_str());
 }
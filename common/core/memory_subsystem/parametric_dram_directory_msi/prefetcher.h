@@ -3,14 +3,19 @@
 
 #include "fixed_types.h"
 
-#include <vector>
-
 class Prefetcher
 {
    public:
+      // Size of the buffer the caller passes to getNextAddress
+      static const UInt32 MAX_PREFETCHES = 32;
+
       static Prefetcher* createPrefetcher(String type, String configName, core_id_t core_id, UInt32 shared_cores);
 
-      virtual std::vector<IntPtr> getNextAddress(IntPtr current_address, core_id_t core_id) = 0;
+      virtual ~Prefetcher() {}
+
+      // Train on an access by instruction eip (0 if unknown) and write at most max_addresses
+      // prefetch candidates into addresses, returns the number of candidates written
+      virtual UInt32 getNextAddress(IntPtr current_address, IntPtr eip, core_id_t core_id, IntPtr *addresses, UInt32 max_addresses) = 0;
 };
 
 #endif // PREFETCHER_H
@@ -0,0 +1,69 @@
+#include "stride_prefetcher.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "log.h"
+
+static const IntPtr PAGE_SIZE = 4096;
+static const IntPtr PAGE_MASK = ~(PAGE_SIZE-1);
+
+StridePrefetcher::StridePrefetcher(String configName, core_id_t core_id)
+   : m_cache_block_size(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/cache_block_size", core_id))
+   , m_degree(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/stride/degree", core_id))
+   , m_confidence_threshold(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/stride/confidence_threshold", core_id))
+   , m_stop_at_page(Sim()->getCfg()->getBoolArray("perf_model/" + configName + "/prefetcher/stride/stop_at_page_boundary", core_id))
+   , m_table(Sim()->getCfg()->getIntArray("perf_model/" + configName + "/prefetcher/stride/table_size", core_id))
+{
+   LOG_ASSERT_ERROR(m_table.size() > 0, "perf_model/%s/prefetcher/stride/table_size must be at least 1", configName.c_str());
+   LOG_ASSERT_ERROR(m_confidence_threshold <= MAX_CONFIDENCE, "perf_model/%s/prefetcher/stride/confidence_threshold must be at most %u", configName.c_str(), MAX_CONFIDENCE);
+}
+
+UInt32
+StridePrefetcher::getNextAddress(IntPtr current_address, IntPtr eip, core_id_t core_id, IntPtr *addresses, UInt32 max_addresses)
+{
+   IntPtr tag = eip ? eip : current_address & PAGE_MASK;
+   Entry &entry = m_table[(tag ^ (tag >> 12)) % m_table.size()];
+
+   if (entry.tag != tag)
+   {
+      entry.tag = tag;
+      entry.last_address = current_address;
+      entry.stride = 0;
+      entry.confidence = 0;
+      return 0;
+   }
+
+   SInt64 stride = current_address - entry.last_address;
+   if (stride == 0)
+      return 0;
+
+   entry.last_address = current_address;
+   if (stride == entry.stride)
+   {
+      if (entry.confidence < MAX_CONFIDENCE)
+         entry.confidence++;
+   }
+   else
+   {
+      entry.stride = stride;
+      entry.confidence = 0;
+   }
+
+   if (entry.confidence < m_confidence_threshold)
+      return 0;
+
+   // Sub-line strides: stream over the next lines
+   SInt64 step = stride;
+   if (stride > -SInt64(m_cache_block_size) && stride < SInt64(m_cache_block_size))
+      step = stride > 0 ? m_cache_block_size : -SInt64(m_cache_block_size);
+
+   UInt32 count = 0;
+   for(UInt32 i = 1; i <= m_degree && count < max_addresses; ++i)
+   {
+      IntPtr prefetch_address = current_address + i * step;
+      if (m_stop_at_page && (prefetch_address & PAGE_MASK) != (current_address & PAGE_MASK))
+         break;
+      addresses[count++] = prefetch_address;
+   }
+
+   return count;
+}
@@ -0,0 +1,37 @@
+#ifndef __STRIDE_PREFETCHER_H
+#define __STRIDE_PREFETCHER_H
+
+#include "prefetcher.h"
+
+#include <vector>
+
+// Per-PC stride prefetcher: a direct-mapped table indexed by the load/store PC keeps the last address and stride
+// of every instruction, once the same stride was seen confidence_threshold times in a row, the next degree strides
+// are prefetched. Strides smaller than a cache line become a stream over the next degree lines in that direction.
+// Without a PC (accesses forwarded by a previous-level cache) the table is indexed by page, i.e. a stream prefetcher.
+class StridePrefetcher : public Prefetcher
+{
+   public:
+      StridePrefetcher(String configName, core_id_t core_id);
+      UInt32 getNextAddress(IntPtr current_address, IntPtr eip, core_id_t core_id, IntPtr *addresses, UInt32 max_addresses) override;
+
+   private:
+      static const UInt32 MAX_CONFIDENCE = 3;
+
+      struct Entry
+      {
+         IntPtr tag;
+         IntPtr last_address;
+         SInt64 stride;
+         UInt32 confidence;
+         Entry() : tag(INVALID_ADDRESS), last_address(0), stride(0), confidence(0) {}
+      };
+
+      const UInt32 m_cache_block_size;
+      const UInt32 m_degree;
+      const UInt32 m_confidence_threshold;
+      const bool m_stop_at_page;
+      std::vector<Entry> m_table;
+};
+
+#endif // __STRIDE_PREFETCHER_H
@@ -6,6 +6,9 @@
 #include "stats.h"
 #include "fault_injection.h"
 #include "shmem_perf.h"
+#include "config.h"
+#include "config.hpp"
+#include "itostr.h"
 
 #if 0
    extern Lock iolock;
@@ -25,6 +28,8 @@ DramCntlr::DramCntlr(MemoryManagerBase* memory_manager,
       ShmemPerfModel* shmem_perf_model,
       UInt32 cache_block_size)
    : DramCntlrInterface(memory_manager, shmem_perf_model, cache_block_size)
+   , m_data(nullptr)
+   , m_snapshot(Sim()->getCfg()->getBoolDefault("perf_model/dram/arena/snapshot", false))
    , m_reads(0)
    , m_writes(0)
 {
@@ -36,6 +41,14 @@ DramCntlr::DramCntlr(MemoryManagerBase* memory_manager,
       ? Sim()->getFaultinjectionManager()->getFaultInjector(memory_manager->getCore()->getId(), MemComponent::DRAM)
       : NULL;
 
+   if (Sim()->getFaultinjectionManager() || m_snapshot)
+   {
+      const UInt64 chunk_size = Sim()->getCfg()->hasKey("perf_model/dram/arena/chunk_size")
+                                   ? Sim()->getCfg()->getInt("perf_model/dram/arena/chunk_size") : 4096;
+      m_data = new DramDataArena(chunk_size, Sim()->getCfg()->getBoolDefault("perf_model/dram/arena/mmap", false));
+      registerStatsMetric("dram", memory_manager->getCore()->getId(), "arena-chunks", m_data->getNumChunks());
+   }
+
    m_dram_access_count = new AccessCountMap[DramCntlrInterface::NUM_ACCESS_TYPES];
    registerStatsMetric("dram", memory_manager->getCore()->getId(), "reads", &m_reads);
    registerStatsMetric("dram", memory_manager->getCore()->getId(), "writes", &m_writes);
@@ -46,25 +59,25 @@ DramCntlr::~DramCntlr()
    printDramAccessCount();
    delete [] m_dram_access_count;
 
+   if (m_snapshot)
+      m_data->dump(Sim()->getConfig()->formatOutputFileName("dram-" + itostr(getMemoryManager()->getCore()->getId()) + ".snapshot"));
+   delete m_data;
+
    delete m_dram_perf_model;
 }
 
 boost::tuple<SubsecondTime, HitWhere::where_t>
 DramCntlr::getDataFromDram(IntPtr address, core_id_t requester, Byte* data_buf, SubsecondTime now, ShmemPerf *perf)
 {
-   if (Sim()->getFaultinjectionManager())
+   if (m_data)
    {
-      if (m_data_map.count(address) == 0)
-      {
-         m_data_map[address] = new Byte[getCacheBlockSize()];
-         memset((void*) m_data_map[address], 0x00, getCacheBlockSize());
-      }
+      Byte* line = m_data->get(address, getCacheBlockSize());
 
       // NOTE: assumes error occurs in memory. If we want to model bus errors, insert the error into data_buf instead
       if (m_fault_injector)
-         m_fault_injector->preRead(address, address, getCacheBlockSize(), (Byte*)m_data_map[address], now);
+         m_fault_injector->preRead(address, address, getCacheBlockSize(), line, now);
 
-      memcpy((void*) data_buf, (void*) m_data_map[address], getCacheBlockSize());
+      memcpy((void*) data_buf, (void*) line, getCacheBlockSize());
    }
 
    SubsecondTime dram_access_latency = runDramPerfModel(requester, now, address, READ, perf);
@@ -81,17 +94,14 @@ DramCntlr::getDataFromDram(IntPtr address, core_id_t requester, Byte* data_buf,
 boost::tuple<SubsecondTime, HitWhere::where_t>
 DramCntlr::putDataToDram(IntPtr address, core_id_t requester, Byte* data_buf, SubsecondTime now)
 {
-   if (Sim()->getFaultinjectionManager())
+   if (m_data)
    {
-      if (m_data_map[address] == NULL)
-      {
-         LOG_PRINT_ERROR("Data Buffer does not exist");
-      }
-      memcpy((void*) m_data_map[address], (void*) data_buf, getCacheBlockSize());
+      Byte* line = m_data->get(address, getCacheBlockSize());
+      memcpy((void*) line, (void*) data_buf, getCacheBlockSize());
 
       // NOTE: assumes error occurs in memory. If we want to model bus errors, insert the error into data_buf instead
       if (m_fault_injector)
-         m_fault_injector->postWrite(address, address, getCacheBlockSize(), (Byte*)m_data_map[address], now);
+         m_fault_injector->postWrite(address, address, getCacheBlockSize(), line, now);
    }
 
    SubsecondTime dram_access_latency = runDramPerfModel(requester, now, address, WRITE, &m_dummy_shmem_perf);
@@ -105,6 +115,22 @@ DramCntlr::putDataToDram(IntPtr address, core_id_t requester, Byte* data_buf, Su
    return boost::tuple<SubsecondTime, HitWhere::where_t>(dram_access_latency, HitWhere::DRAM);
 }
 
+void
+DramCntlr::persistDataToDram(IntPtr address, Byte* data_buf, SubsecondTime now)
+{
+   if (m_data)
+   {
+      Byte* line = m_data->get(address, getCacheBlockSize());
+      memcpy((void*) line, (void*) data_buf, getCacheBlockSize());
+
+      if (m_fault_injector)
+         m_fault_injector->postWrite(address, address, getCacheBlockSize(), line, now);
+   }
+
+   ++m_writes;
+   MYLOG("P @ %08lx", address);
+}
+
 SubsecondTime
 DramCntlr::runDramPerfModel(core_id_t requester, SubsecondTime time, IntPtr address, DramCntlrInterface::access_t access_type, ShmemPerf *perf)
 {
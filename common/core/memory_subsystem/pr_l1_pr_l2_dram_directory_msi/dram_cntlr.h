@@ -5,6 +5,7 @@
 
 #include <unordered_map>
 
+#include "dram_data_arena.h"
 #include "dram_perf_model.h"
 #include "shmem_msg.h"
 #include "shmem_perf.h"
@@ -20,7 +21,8 @@ namespace PrL1PrL2DramDirectoryMSI
    class DramCntlr : public DramCntlrInterface
    {
       private:
-         std::unordered_map<IntPtr, Byte*> m_data_map;
+         DramDataArena* m_data; // Functional contents, only kept for fault injection or snapshots
+         bool m_snapshot;
          DramPerfModel* m_dram_perf_model;
          FaultInjector* m_fault_injector;
 
@@ -43,9 +45,11 @@ namespace PrL1PrL2DramDirectoryMSI
          ~DramCntlr();
 
          DramPerfModel* getDramPerfModel() { return m_dram_perf_model; }
+         DramDataArena* getDataArena() { return m_data; }
 
          // Run DRAM performance model. Pass in begin time, returns latency
          boost::tuple<SubsecondTime, HitWhere::where_t> getDataFromDram(IntPtr address, core_id_t requester, Byte* data_buf, SubsecondTime now, ShmemPerf *perf);
          boost::tuple<SubsecondTime, HitWhere::where_t> putDataToDram(IntPtr address, core_id_t requester, Byte* data_buf, SubsecondTime now);
+         void persistDataToDram(IntPtr address, Byte* data_buf, SubsecondTime now);
    };
 }
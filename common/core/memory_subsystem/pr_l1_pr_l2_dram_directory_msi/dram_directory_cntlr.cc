@@ -6,6 +6,9 @@
 #include "shmem_perf.h"
 #include "coherency_protocol.h"
 #include "config.hpp"
+#include "shmem_batch.h"
+
+#include <unordered_map>
 
 #if 0
    extern Lock iolock;
@@ -50,7 +53,9 @@ DramDirectoryCntlr::DramDirectoryCntlr(core_id_t core_id,
    m_cache_block_size(cache_block_size),
    m_shmem_perf_model(shmem_perf_model),
    forward(0),
-   forward_failed(0)
+   forward_failed(0),
+   commits(0),
+   persists(0)
 {
    m_dram_directory_cache = new DramDirectoryCache(
          core_id,
@@ -73,6 +78,8 @@ DramDirectoryCntlr::DramDirectoryCntlr(core_id_t core_id,
    }
    registerStatsMetric("directory", core_id, "forward", &forward);
    registerStatsMetric("directory", core_id, "forward-failed", &forward_failed);
+   registerStatsMetric("directory", core_id, "commits", &commits);
+   registerStatsMetric("directory", core_id, "persists", &persists);
 
    String protocol = Sim()->getCfg()->getString("caching_protocol/variant");
    if (protocol == "msi")
@@ -170,6 +177,16 @@ DramDirectoryCntlr::handleMsgFromL2Cache(core_id_t sender, ShmemMsg* shmem_msg)
          processWbRepFromL2Cache(sender, shmem_msg);
          break;
 
+      case ShmemMsg::COMMIT:
+         MYLOG("COMMIT<%u @ %lx", sender, address);
+         processCommitFromL2Cache(sender, shmem_msg);
+         break;
+
+      case ShmemMsg::PERSIST:
+         MYLOG("PERSIST<%u @ %lx", sender, address);
+         processPersistFromL2Cache(sender, shmem_msg);
+         break;
+
       default:
          LOG_PRINT_ERROR("Unrecognized Shmem Msg Type: %u", shmem_msg_type);
          break;
@@ -1196,6 +1213,45 @@ DramDirectoryCntlr::processWbRepFromL2Cache(core_id_t sender, ShmemMsg* shmem_ms
    MYLOG("End @ %lx", address);
 }
 
+void
+DramDirectoryCntlr::processCommitFromL2Cache(core_id_t sender, ShmemMsg* shmem_msg)
+{
+   // Committed lines stay cached (clean) at the LLC, so their directory entries are left untouched
+   commits += ShmemBatch::getSize(shmem_msg->getDataBuf());
+}
+
+void
+DramDirectoryCntlr::processPersistFromL2Cache(core_id_t sender, ShmemMsg* shmem_msg)
+{
+   Byte* batch_buf = shmem_msg->getDataBuf();
+   const UInt64 num_lines = ShmemBatch::getSize(batch_buf);
+
+   // Forward one batch per memory controller. Persists bypass the NUCA cache: they are only durable in memory.
+   std::unordered_map<core_id_t, ShmemBatch> batches;
+   for (UInt64 i = 0; i < num_lines; i++)
+   {
+      IntPtr address = ShmemBatch::getAddress(batch_buf, i);
+      core_id_t dram_node = m_dram_controller_home_lookup->getHome(address);
+      batches.try_emplace(dram_node, getCacheBlockSize(), ShmemBatch::getEID(batch_buf)).first->second.add(address, ShmemBatch::getData(batch_buf, i, getCacheBlockSize()));
+   }
+
+   for (const auto& [dram_node, batch] : batches)
+   {
+      std::vector<Byte> buf = batch.makeBuf(true);
+      getMemoryManager()->sendMsg(ShmemMsg::PERSIST,
+            MemComponent::TAG_DIR, MemComponent::DRAM,
+            shmem_msg->getRequester() /* requester */,
+            dram_node /* receiver */,
+            batch.front(),
+            buf.data(), buf.size(),
+            HitWhere::UNKNOWN,
+            &m_dummy_shmem_perf,
+            ShmemPerfModel::_SIM_THREAD);
+   }
+
+   persists += num_lines;
+}
+
 void
 DramDirectoryCntlr::sendDataToNUCA(IntPtr address, core_id_t requester, Byte* data_buf, SubsecondTime now, bool count)
 {
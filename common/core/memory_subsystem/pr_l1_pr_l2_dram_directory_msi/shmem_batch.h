@@ -0,0 +1,86 @@
+#pragma once
+
+#include "fixed_types.h"
+
+#include <cstring>
+#include <vector>
+
+namespace PrL1PrL2DramDirectoryMSI
+{
+   /**
+    * Payload of the batched checkpoint messages (COMMIT and PERSIST).
+    *
+    * A checkpoint sends one COMMIT and one PERSIST message per home tag directory instead of one per line.
+    * Layout of the data buffer: the number of lines, the epoch of the checkpoint, the address of every line and,
+    * for PERSIST, the data of every line. The modelled length of a batch is the sum of the modelled lengths of its lines.
+    */
+   class ShmemBatch
+   {
+      public:
+         ShmemBatch(const UInt32 line_size, const UInt64 eid) : m_line_size(line_size), m_eid(eid) {}
+
+         void add(IntPtr address, const Byte* data)
+         {
+            m_addresses.push_back(address);
+            if (data != nullptr)
+               m_data.insert(m_data.end(), data, data + m_line_size);
+         }
+
+         [[nodiscard]] bool empty() const { return m_addresses.empty(); }
+         [[nodiscard]] UInt64 size() const { return m_addresses.size(); }
+         [[nodiscard]] IntPtr front() const { return m_addresses.front(); }
+         [[nodiscard]] UInt64 getEID() const { return m_eid; }
+         [[nodiscard]] const std::vector<IntPtr>& getAddresses() const { return m_addresses; }
+
+         // Build the message payload, with_data is true for PERSIST
+         [[nodiscard]] std::vector<Byte> makeBuf(bool with_data) const
+         {
+            const UInt64 count = m_addresses.size();
+            std::vector<Byte> buf(HEADER_SIZE + count * sizeof(IntPtr) + (with_data ? m_data.size() : 0));
+            memcpy(buf.data(), &count, sizeof(count));
+            memcpy(buf.data() + sizeof(count), &m_eid, sizeof(m_eid));
+            memcpy(buf.data() + HEADER_SIZE, m_addresses.data(), count * sizeof(IntPtr));
+            if (with_data)
+               memcpy(buf.data() + HEADER_SIZE + count * sizeof(IntPtr), m_data.data(), m_data.size());
+            return buf;
+         }
+
+         // Accessors on a received payload
+         static UInt64 getSize(const Byte* buf)
+         {
+            UInt64 count;
+            memcpy(&count, buf, sizeof(count));
+            return count;
+         }
+         static UInt64 getEID(const Byte* buf)
+         {
+            UInt64 eid;
+            memcpy(&eid, buf + sizeof(UInt64), sizeof(eid));
+            return eid;
+         }
+         static IntPtr getAddress(const Byte* buf, const UInt64 index)
+         {
+            IntPtr address;
+            memcpy(&address, buf + HEADER_SIZE + index * sizeof(IntPtr), sizeof(address));
+            return address;
+         }
+         static Byte* getData(Byte* buf, const UInt64 index, const UInt32 line_size)
+         {
+            return buf + HEADER_SIZE + getSize(buf) * sizeof(IntPtr) + index * line_size;
+         }
+
+         // msg_type (1 byte) + address (+ cache block) for every line
+         static UInt32 getModeledLength(const Byte* buf, const UInt32 data_length)
+         {
+            return getSize(buf) + data_length - HEADER_SIZE;
+         }
+
+      private:
+         static const UInt32 HEADER_SIZE = 2 * sizeof(UInt64); // Number of lines and epoch
+
+         const UInt32 m_line_size;
+         const UInt64 m_eid;
+         std::vector<IntPtr> m_addresses;
+         std::vector<Byte> m_data;
+   };
+}
@@ -1,6 +1,7 @@
 #include <cstring>
 #include "shmem_msg.h"
 #include "shmem_perf.h"
+#include "shmem_batch.h"
 #include "log.h"
 
 namespace PrL1PrL2DramDirectoryMSI
@@ -96,7 +97,6 @@ namespace PrL1PrL2DramDirectoryMSI
          case UPGRADE_REP:
          case UPGRADE_REQ:
          case INV_REP:
-         case COMMIT:         // Added by Kleber Kruger
          case DRAM_READ_REQ:
             // msg_type + address
             // msg_type - 1 byte
@@ -106,12 +106,16 @@ namespace PrL1PrL2DramDirectoryMSI
          case SH_REP:
          case FLUSH_REP:
          case WB_REP:
-         case PERSIST:        // Added by Kleber Kruger
          case DRAM_WRITE_REQ:
          case DRAM_READ_REP:
             // msg_type + address + cache_block
             return 1 + sizeof(IntPtr) + m_data_length;
 
+         case COMMIT:         // Added by Kleber Kruger
+         case PERSIST:        // Added by Kleber Kruger
+            // Checkpoint batches: (msg_type + address (+ cache_block)) for every line
+            return ShmemBatch::getModeledLength(m_data_buf, m_data_length);
+
          default:
             LOG_PRINT_ERROR("Unrecognized Msg Type(%u)", m_msg_type);
       }
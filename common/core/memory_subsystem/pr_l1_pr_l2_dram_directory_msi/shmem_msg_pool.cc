@@ -0,0 +1,104 @@
+#include "shmem_msg_pool.h"
+#include "log.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace PrL1PrL2DramDirectoryMSI
+{
+   ShmemMsgPool::ShmemMsgPool(const UInt32 payload_size) :
+      m_payload_size(payload_size),
+      // Round the slots up to cache lines so that a sender and a receiver do not share one
+      m_slot_size((sizeof(Slot) + payload_size + 63) & ~63),
+      m_free(nullptr),
+      m_refs(1)
+   {}
+
+   ShmemMsgPool::~ShmemMsgPool()
+   {
+      for (Byte* chunk : m_chunks)
+         free(chunk);
+   }
+
+   bool
+   ShmemMsgPool::unref()
+   {
+      LOG_ASSERT_ERROR(m_refs > 0, "ShmemMsgPool reference count underflow");
+      return --m_refs == 0;
+   }
+
+   void
+   ShmemMsgPool::destroy()
+   {
+      bool last;
+      {
+         ScopedLock sl(m_lock);
+         last = unref();
+      }
+      if (last)
+         delete this;
+   }
+
+   void
+   ShmemMsgPool::grow()
+   {
+      Byte* chunk;
+      __attribute__((unused)) int rc = posix_memalign((void**) &chunk, 64, SLOTS_PER_CHUNK * m_slot_size);
+      LOG_ASSERT_ERROR(rc == 0, "posix_memalign failed to allocate memory");
+      m_chunks.push_back(chunk);
+
+      for (UInt32 i = 0; i < SLOTS_PER_CHUNK; i++)
+      {
+         auto* slot = reinterpret_cast<Slot*>(chunk + i * m_slot_size);
+         slot->pool = this;
+         slot->next = m_free;
+         m_free = slot;
+      }
+   }
+
+   ShmemMsg*
+   ShmemMsgPool::create(const ShmemMsg& msg)
+   {
+      Slot* slot;
+      {
+         ScopedLock sl(m_lock);
+         if (m_free == nullptr)
+            grow();
+         slot = m_free;
+         m_free = slot->next;
+         m_refs++;
+      }
+
+      auto* shmem_msg = new (slot->msg) ShmemMsg(&msg);
+      if (msg.getDataLength() > 0)
+      {
+         Byte* data_buf = msg.getDataLength() <= m_payload_size ? getPayload(slot) : new Byte[msg.getDataLength()];
+         memcpy(data_buf, msg.getDataBuf(), msg.getDataLength());
+         shmem_msg->setDataBuf(data_buf);
+      }
+      return shmem_msg;
+   }
+
+   void
+   ShmemMsgPool::release(ShmemMsg* msg)
+   {
+      auto* slot = reinterpret_cast<Slot*>(msg);
+      ShmemMsgPool* pool = slot->pool;
+
+      if (msg->getDataLength() > pool->m_payload_size)
+         delete [] msg->getDataBuf();
+      msg->~ShmemMsg();
+
+      bool last;
+      {
+         ScopedLock sl(pool->m_lock);
+         slot->next = pool->m_free;
+         pool->m_free = slot;
+         last = pool->unref();
+      }
+      // The owner is gone and this was its last message
+      if (last)
+         delete pool;
+   }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "shmem_msg.h"
+#include "fixed_types.h"
+#include "lock.h"
+
+#include <vector>
+
+namespace PrL1PrL2DramDirectoryMSI
+{
+   /**
+    * Storage for the messages passed by pointer through the network: each slot holds a ShmemMsg followed by
+    * room for one cache line, so sending a message costs no allocation. The receiver owns the message and
+    * gives it back with release(), usually from another thread than the sender's.
+    *
+    * The pool is reference-counted: its owner and every message not released yet hold a reference. The owner
+    * drops its reference with destroy() instead of deleting the pool, so a message still in the network (or
+    * being handled by another memory manager) at teardown can be released safely; the last reference frees
+    * the pool.
+    */
+   class ShmemMsgPool
+   {
+      public:
+         explicit ShmemMsgPool(UInt32 payload_size);
+
+         ShmemMsgPool(const ShmemMsgPool&) = delete;
+         ShmemMsgPool& operator=(const ShmemMsgPool&) = delete;
+
+         // Copy of a message and its payload in pooled storage
+         ShmemMsg* create(const ShmemMsg& msg);
+         static void release(ShmemMsg* msg);
+         // Drop the owner's reference
+         void destroy();
+
+      private:
+         struct Slot
+         {
+            alignas(ShmemMsg) Byte msg[sizeof(ShmemMsg)]; // First, so the message and its slot share the address
+            ShmemMsgPool* pool;
+            Slot* next;
+         };
+
+         static const UInt32 SLOTS_PER_CHUNK = 256;
+
+         const UInt32 m_payload_size; // Larger payloads (checkpoint batches) get their own buffer
+         const UInt32 m_slot_size;
+         std::vector<Byte*> m_chunks;
+         Slot* m_free;
+         UInt64 m_refs; // Owner and outstanding messages, protected by m_lock
+         Lock m_lock;
+
+         ~ShmemMsgPool();
+         void grow();
+         bool unref(); // Called with m_lock held, true when the pool must be deleted
+         static Byte* getPayload(Slot* slot) { return reinterpret_cast<Byte*>(slot) + sizeof(Slot); }
+   };
+}
@@ -10,7 +10,8 @@ public:
       PERIODIC_TIME,
       PERIODIC_INSTRUCTIONS,
       CACHE_SET_THRESHOLD,
-      CACHE_THRESHOLD
+      CACHE_THRESHOLD,
+      COORDINATED       // Another LLC slice ended the epoch
    };
 
    CheckpointEvent(const Reason reason, const SubsecondTime& time, const IntPtr pc,
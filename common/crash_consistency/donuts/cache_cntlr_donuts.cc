@@ -2,7 +2,11 @@
 #include "memory_manager.h"
 #include "hooks_manager.h"
 #include "simulator.h"
+#include "core_manager.h"
 #include "config.hpp"
+#include "config.h"
+
+#include <unordered_map>
 
 #include <ranges>
 
@@ -19,11 +23,19 @@ CacheCntlrDonuts::CacheCntlrDonuts(MemComponent::component_t mem_component,
                                    UInt32 cache_block_size,
                                    CacheParameters& cache_params,
                                    ShmemPerfModel* shmem_perf_model,
-                                   bool is_last_level_cache,
-                                   EpochCntlr* epoch_cntlr) :
+                                   bool is_last_level_cache) :
       CacheCntlr(mem_component, name, core_id, memory_manager, tag_directory_home_lookup, user_thread_sem, network_thread_sem, cache_block_size, cache_params, shmem_perf_model, is_last_level_cache),
-m_epoch_cntlr(epoch_cntlr),
-    m_persistence_policy(getPersistencePolicy())
+m_epoch_cntlr(nullptr),
+    m_persistence_policy(getPersistencePolicy()),
+    m_checkpoint_mode(getCheckpointMode()),
+    m_donuts_master(nullptr),
+    m_persist_scheduler(nullptr),
+    m_timeout_expired(false),
+    m_timeout_ins_expired(false),
+    m_coordinated_checkpoints(0),
+    m_checkpoint_stall_time(SubsecondTime::Zero()),
+    m_pending_write_stalls(0),
+    m_pending_write_stall_time(SubsecondTime::Zero())
 {
 //   printf("Cache %s (%p) | CacheCntlr (%p) | Core %u/%u\n", getCache()->getName().c_str(), getCache(), this, m_core_id, m_core_id_master);
 
@@ -31,56 +43,89 @@ m_epoch_cntlr(epoch_cntlr),
    {
       LOG_ASSERT_ERROR(!m_cache_writethrough, "DONUTS does not allow LLC write-through");
 
-      // TODO: Implement for non-unified LLC... Use a Master Controller??
-      LOG_ASSERT_ERROR(m_core_id_master == 0, "DONUTS does not allow non-unified LLC yet");
+      // Each LLC slice checkpoints its own dirty lines, the slices are kept on the same epoch by the epoch manager
+      if (isMasterCache())
+      {
+         m_donuts_master = this;
+         m_persist_scheduler = new PersistScheduler(name, core_id, cache_block_size, tag_directory_home_lookup,
+                                                    memory_manager->getDramControllerHomeLookup());
+
+         // The cores sharing this LLC form one persistence domain
+         const UInt32 num_cores = std::min<UInt32>(m_shared_cores, Config::getSingleton()->getTotalCores() - m_core_id);
+         m_epoch_cntlr = Sim()->getEpochManager()->createEpochCntlr(m_core_id, num_cores);
+
+         Sim()->getHooksManager()->registerHook(HookType::HOOK_EPOCH_TIMEOUT, _checkpoint_timeout, (UInt64) this);
+         Sim()->getHooksManager()->registerHook(HookType::HOOK_EPOCH_TIMEOUT_INS, _checkpoint_instr, (UInt64) this);
+      }
+      else
+      {
+         m_donuts_master = dynamic_cast<CacheCntlrDonuts*>(getMemoryManager()->getCacheCntlrAt(m_core_id_master, mem_component));
+         m_persist_scheduler = m_donuts_master->m_persist_scheduler;
+         m_epoch_cntlr = m_donuts_master->m_epoch_cntlr;
+      }
+
+      // Every level of the cores of the domain stamps the epochs of the domain on its dirty blocks
+      // (the LLC controller is created last, the lower levels of this core already exist)
+      for (UInt32 level = MemComponent::FIRST_LEVEL_CACHE; level < (UInt32) mem_component; level++)
+         getMemoryManager()->getCacheCntlrAt(m_core_id, (MemComponent::component_t) level)->getCache()->enableEpochTagging(m_epoch_cntlr);
+      getCache()->enableEpochTagging(m_epoch_cntlr);
 
-//      Sim()->getHooksManager()->registerHook(HookType::HOOK_EPOCH_TIMEOUT, _checkpoint_timeout, (UInt64) this);
-//      Sim()->getHooksManager()->registerHook(HookType::HOOK_EPOCH_TIMEOUT_INS, _checkpoint_instr, (UInt64) this);
+      registerStatsMetric(name, core_id, "coordinated-checkpoints", &m_coordinated_checkpoints);
+      registerStatsMetric(name, core_id, "checkpoint-stall-time", &m_checkpoint_stall_time);
+      registerStatsMetric(name, core_id, "pending-write-stalls", &m_pending_write_stalls);
+      registerStatsMetric(name, core_id, "pending-write-stall-time", &m_pending_write_stall_time);
    }
 }
 
-CacheCntlrDonuts::~CacheCntlrDonuts() = default;
+CacheCntlrDonuts::~CacheCntlrDonuts()
+{
+   if (m_donuts_master == this)
+      delete m_persist_scheduler;
+}
 
 void
-CacheCntlrDonuts::addAllDirtyBlocks(std::queue<CacheBlockInfo*>& dirty_blocks, UInt32 set_index) const
+CacheCntlrDonuts::addDirtyBlocks(std::vector<IntPtr>& dirty_blocks, UInt32 set_index) const
 {
-   for (UInt32 way = 0; way < m_master->m_cache->getAssociativity(); way++)
-   {
-      CacheBlockInfo* block_info = m_master->m_cache->peekBlock(set_index, way);
-      if (block_info->isDirty())
-         dirty_blocks.push(block_info);
-   }
+   const Cache* cache = m_master->m_cache;
+   cache->getDirtyTracker()->forEachDirtyWay(set_index, [&](const UInt32 way) {
+      dirty_blocks.push_back(cache->tagToAddress(cache->peekBlock(set_index, way)->getTag()));
+   });
 }
 
 /**
  * Select the dirty blocks from the cache according to persistence policy.
- * TODO: When it is a non-unified cache, you must get all the dirty cache blocks that will be on other controllers.
+ * The blocks are taken from the dirty-block index of the LLC, so the cost is O(number of dirty blocks).
+ * The blocks of the evicted set always go first. BALANCED then interleaves the remaining blocks
+ * across the memory controllers and banks, so the write-backs drain in parallel.
  *
  * @param evicted_set_index
- * @return a sorted queue containing all the dirty blocks
+ * @return the addresses of all the dirty blocks, in flush order
  */
-std::queue<CacheBlockInfo*>
+std::vector<IntPtr>
 CacheCntlrDonuts::selectDirtyBlocks(UInt32 evicted_set_index) const
 {
-   LOG_ASSERT_ERROR(m_persistence_policy != PersistencePolicy::BALANCED, "Persistence policy not yet implemented");
+   const CacheDirtyTracker* dirty_tracker = m_master->m_cache->getDirtyTracker();
 
-   std::queue<CacheBlockInfo*> dirty_blocks;
-   std::vector<std::pair<UInt32, double> > other_sets;
+   // Snapshot the addresses: committing the blocks updates the index while we flush them
+   std::vector<IntPtr> dirty_blocks;
+   dirty_blocks.reserve(dirty_tracker->getNumDirty());
 
-   addAllDirtyBlocks(dirty_blocks, evicted_set_index);
+   addDirtyBlocks(dirty_blocks, evicted_set_index);
 
-   for (UInt32 i = 0; i < m_master->m_cache->getNumSets(); i++)
-   {
-      if (i == evicted_set_index) continue;
-      const auto used = m_persistence_policy == PersistencePolicy::FULLEST_FIRST ? m_master->m_cache->getSetCapacityUsed(i) : 1;
-      if (used > 0) other_sets.emplace_back(i, used);
-   }
+   const auto add_set = [&](const UInt32 set_index) {
+      if (set_index != evicted_set_index)
+         addDirtyBlocks(dirty_blocks, set_index);
+   };
+
+   const UInt32 num_evicted = dirty_blocks.size();
 
    if (m_persistence_policy == PersistencePolicy::FULLEST_FIRST)
-      std::sort(other_sets.begin(), other_sets.end(), [](const auto& a, const auto& b) { return (a.second > b.second); });
+      dirty_tracker->forEachDirtySetByFillLevel(add_set);
+   else
+      dirty_tracker->forEachDirtySetByIndex(add_set);
 
-   for (auto set: other_sets)
-      addAllDirtyBlocks(dirty_blocks, set.first);
+   if (m_persistence_policy == PersistencePolicy::BALANCED)
+      m_persist_scheduler->balance(dirty_blocks, num_evicted);
 
    return dirty_blocks;
 }
@@ -90,32 +135,245 @@ CacheCntlrDonuts::checkpoint(CheckpointReason event_type, UInt32 evicted_set_ind
 {
    LOG_ASSERT_ERROR(isLastLevel(), "Only the LLC controller can perform a checkpoint");
 
+   // Threshold checkpoints are triggered by the LLC fills, which the sim thread does for the directory replies
+   const ShmemPerfModel::Thread_t thread_num = Sim()->getCoreManager()->amiSimThread() ? ShmemPerfModel::_SIM_THREAD : ShmemPerfModel::_USER_THREAD;
+
+   // The LLC is shared: checkpoints triggered by different cores are serialized at the master
+   {
+      ScopedLock sl(m_donuts_master->m_checkpoint_lock);
+      checkpointLocked(event_type, evicted_set_index, thread_num);
+   }
+   advanceIdleSlices(getShmemPerfModel()->getElapsedTime(thread_num));
+}
+
+/**
+ * Another LLC slice ended the epoch: flush the dirty lines of this slice too, so all the slices persist the same
+ * epochs. Called by the cores of the slice on their next LLC access, so each slice flushes in parallel in its own
+ * thread and no slice ever touches the cache of another one.
+ */
+void
+CacheCntlrDonuts::catchUp()
+{
+   if (m_epoch_cntlr->getCurrentEID() >= Sim()->getEpochManager()->getTargetEID())
+      return;
+
+   {
+      ScopedLock sl(m_donuts_master->m_checkpoint_lock);
+      while (m_epoch_cntlr->getCurrentEID() < Sim()->getEpochManager()->getTargetEID())
+      {
+         m_coordinated_checkpoints++;
+         checkpointLocked(CheckpointReason::COORDINATED, 0, ShmemPerfModel::_USER_THREAD);
+      }
+   }
+   advanceIdleSlices(getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD));
+}
+
+/**
+ * A slice whose cores do not access the LLC would never catch up on its own, and the persisted epoch of the
+ * system would stall. Once this slice has released its checkpoint lock, the slices behind the target epoch
+ * that have no dirty lines end their epochs right away: there is nothing to flush, so their caches are not
+ * touched. Slices with dirty lines still catch up on their next LLC access.
+ */
+void
+CacheCntlrDonuts::advanceIdleSlices(const SubsecondTime t_now)
+{
+   const UInt64 target_eid = Sim()->getEpochManager()->getTargetEID();
+   for (const EpochCntlr *epoch_cntlr : Sim()->getEpochManager()->getDomains())
+   {
+      if (epoch_cntlr != m_epoch_cntlr && epoch_cntlr->getCurrentEID() < target_eid)
+         dynamic_cast<CacheCntlrDonuts*>(getMemoryManager()->getCacheCntlrAt(epoch_cntlr->getDomainId(), m_mem_component))->skipIdleEpochs(t_now);
+   }
+}
+
+void
+CacheCntlrDonuts::skipIdleEpochs(const SubsecondTime t_now)
+{
+   ScopedLock sl(m_checkpoint_lock);
+   while (m_epoch_cntlr->getCurrentEID() < Sim()->getEpochManager()->getTargetEID() && getCache()->getDirtyTracker()->getNumDirty() == 0)
+   {
+      m_coordinated_checkpoints++;
+      m_epoch_cntlr->commit(t_now, 0);
+      m_epoch_cntlr->registerPersistedEID(m_epoch_cntlr->getLastCommittedEID(), t_now);
+   }
+}
+
+/**
+ * Periodic checkpoint of an expired epoch, on the LLC access of a core of the domain: the flush runs in the
+ * thread of that core, within its access, like catchUp, and the stall is charged to that core.
+ * The epoch must still be expired once the checkpoint lock is held, so a checkpoint that just ended the epoch
+ * (for any reason) is not followed by a periodic one.
+ */
+void
+CacheCntlrDonuts::checkpointExpired()
+{
+   const bool timeout = m_donuts_master->m_timeout_expired.exchange(false, std::memory_order_relaxed);
+   const bool timeout_ins = m_donuts_master->m_timeout_ins_expired.exchange(false, std::memory_order_relaxed);
+   if (!timeout && !timeout_ins)
+      return;
+
+   {
+      ScopedLock sl(m_donuts_master->m_checkpoint_lock);
+      const SubsecondTime now = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
+      if (timeout && Sim()->getEpochManager()->hasTimedOut(m_epoch_cntlr, now))
+         checkpointLocked(CheckpointReason::PERIODIC_TIME, 0, ShmemPerfModel::_USER_THREAD);
+      else if (timeout_ins && Sim()->getEpochManager()->hasTimedOutIns(m_epoch_cntlr))
+         checkpointLocked(CheckpointReason::PERIODIC_INSTRUCTIONS, 0, ShmemPerfModel::_USER_THREAD);
+      else
+         return;
+   }
+   advanceIdleSlices(getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD));
+}
+
+/**
+ * The timer runs outside of any memory access, so it only marks the epoch of the domain as expired.
+ */
+SInt64
+CacheCntlrDonuts::_checkpoint_timeout(const UInt64 arg, const UInt64 val)
+{
+   auto *cntlr = reinterpret_cast<CacheCntlrDonuts *>(arg);
+
+   const SubsecondTime now(*reinterpret_cast<const subsecond_time_t *>(&val));
+   if (Sim()->getEpochManager()->hasTimedOut(cntlr->m_epoch_cntlr, now))
+      cntlr->m_timeout_expired.store(true, std::memory_order_relaxed);
+   return 0;
+}
+
+SInt64
+CacheCntlrDonuts::_checkpoint_instr(const UInt64 arg, const UInt64 val)
+{
+   auto *cntlr = reinterpret_cast<CacheCntlrDonuts *>(arg);
+
+   if (Sim()->getEpochManager()->hasTimedOutIns(cntlr->m_epoch_cntlr))
+      cntlr->m_timeout_ins_expired.store(true, std::memory_order_relaxed);
+   return 0;
+}
+
+void
+CacheCntlrDonuts::checkpointLocked(CheckpointReason event_type, UInt32 evicted_set_index, ShmemPerfModel::Thread_t thread_num)
+{
    auto dirty_blocks = selectDirtyBlocks(evicted_set_index);
    if (!dirty_blocks.empty())
    {
-      printf("BEFORE checkpoint | Sending in %lu...\n", getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_SIM_THREAD).getNS());
+      const SubsecondTime t_start = getShmemPerfModel()->getElapsedTime(thread_num);
+
+      printf("BEFORE checkpoint | Sending in %lu...\n", t_start.getNS());
       // auto *nvm_cntlr = dynamic_cast<PrL1PrL2DramDirectoryMSI::NvmCntlrDonuts*>(getMemoryManager()->getDramCntlr());
       // nvm_cntlr->checkpoint(event_type, dirty_blocks.size(), m_master->m_cache->getCapacityUsed());
 
-      while (!dirty_blocks.empty())
+      // One COMMIT and one PERSIST batch per home, in the order of the first line of each home
+      std::vector<PrL1PrL2DramDirectoryMSI::ShmemBatch> batches;
+      std::unordered_map<core_id_t, UInt32> batch_index;
+      for (const IntPtr address : dirty_blocks)
+      {
+         auto it = batch_index.find(getHome(address));
+         if (it == batch_index.end())
+         {
+            it = batch_index.emplace(getHome(address), batches.size()).first;
+            batches.emplace_back(getCacheBlockSize(), m_epoch_cntlr->getCurrentEID());
+         }
+         processCommit(address, batches[it->second], thread_num);
+      }
+      for (const auto& batch : batches)
+         processPersist(batch, thread_num);
+
+      if (PersistChecker *checker = Sim()->getEpochManager()->getPersistChecker())
       {
-         auto *cache_block = dirty_blocks.front();
-         IntPtr address = m_master->m_cache->tagToAddress(cache_block->getTag());
-         Byte data_buf[getCacheBlockSize()];
-         processCommit(address, data_buf);
-         processPersist(address, data_buf);
-         dirty_blocks.pop();
+         for (const auto& batch : batches)
+            checker->commitBatch(batch.makeBuf(true));
       }
-      printf("AFTER checkpoint | Sending in %lu...\n", getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_SIM_THREAD).getNS());
 
-      //         UInt64 eid = m_epoch_cntlr->getCurrentEID();
-      //         m_epoch_cntlr->commit();
-      //         m_epoch_cntlr->registerPersistedEID(eid);
+      // The epoch ends with the snapshot of its dirty lines
+      m_epoch_cntlr->commit(t_start, dirty_blocks.size());
+
+      SubsecondTime t_end;
+      if (m_checkpoint_mode == CheckpointMode::SYNC)
+      {
+         t_end = m_persist_scheduler->drain(batches, t_start);
+         m_checkpoint_stall_time += t_end - t_start;
+         getMemoryManager()->incrElapsedTime(t_end - t_start, thread_num);
+      }
+      else
+      {
+         // The dirty lines are snapshotted (now clean in the LLC), the core goes on while they drain
+         std::vector<SubsecondTime> t_persisted;
+         t_end = m_persist_scheduler->drain(batches, t_start, &t_persisted);
+         m_donuts_master->trackPending(batches, t_persisted, t_start);
+      }
+      m_epoch_cntlr->registerPersistedEID(m_epoch_cntlr->getLastCommittedEID(), t_end);
+      printf("AFTER checkpoint | Sending in %lu...\n", t_end.getNS());
+   }
+   else if (event_type == CheckpointReason::PERIODIC_TIME || event_type == CheckpointReason::PERIODIC_INSTRUCTIONS ||
+            event_type == CheckpointReason::COORDINATED)
+   {
+      // Nothing to persist, but the epoch still ends: otherwise the timer would expire again at once,
+      // and the other slices could not agree on the persisted epoch
+      const SubsecondTime t_now = getShmemPerfModel()->getElapsedTime(thread_num);
+      m_epoch_cntlr->commit(t_now, 0);
+      m_epoch_cntlr->registerPersistedEID(m_epoch_cntlr->getLastCommittedEID(), t_now);
    }
 }
 
+/**
+ * Remember the persist time of the lines of an asynchronous checkpoint (master only).
+ * Lines already persisted at t_now are dropped, so the map only holds the lines still in flight.
+ */
 void
-CacheCntlrDonuts::processCommit(IntPtr address, Byte* data_buf)
+CacheCntlrDonuts::trackPending(const std::vector<PrL1PrL2DramDirectoryMSI::ShmemBatch>& batches, const std::vector<SubsecondTime>& t_persisted,
+                               const SubsecondTime t_now)
+{
+   std::erase_if(m_pending, [t_now](const auto& entry) { return entry.second <= t_now; });
+
+   UInt32 i = 0;
+   for (const auto& batch : batches)
+   {
+      for (const IntPtr address : batch.getAddresses())
+         m_pending[address] = t_persisted[i++];
+   }
+}
+
+/**
+ * A write to a line of the previous epoch that is not persisted yet must wait for its persist,
+ * otherwise the new data would overwrite the checkpointed copy.
+ */
+void
+CacheCntlrDonuts::waitForPersist(IntPtr address)
+{
+   SubsecondTime t_persisted;
+   {
+      ScopedLock sl(m_donuts_master->m_checkpoint_lock);
+      auto it = m_donuts_master->m_pending.find(address);
+      if (it == m_donuts_master->m_pending.end())
+         return;
+      t_persisted = it->second;
+   }
+
+   const SubsecondTime t_now = getShmemPerfModel()->getElapsedTime(ShmemPerfModel::_USER_THREAD);
+   if (t_persisted > t_now)
+   {
+      m_pending_write_stalls++;
+      m_pending_write_stall_time += t_persisted - t_now;
+      getMemoryManager()->incrElapsedTime(t_persisted - t_now, ShmemPerfModel::_USER_THREAD);
+   }
+}
+
+HitWhere::where_t
+CacheCntlrDonuts::processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t mem_op_type, IntPtr address, bool modeled, bool count,
+                                               Prefetch::prefetch_type_t isPrefetch, SubsecondTime t_issue, bool have_write_lock, IntPtr eip)
+{
+   if (isLastLevel())
+   {
+      catchUp();
+      checkpointExpired();
+
+      if (m_checkpoint_mode == CheckpointMode::ASYNC && modeled && mem_op_type != Core::READ && isPrefetch == Prefetch::NONE)
+         waitForPersist(address);
+   }
+
+   return CacheCntlr::processShmemReqFromPrevCache(requester, mem_op_type, address, modeled, count, isPrefetch, t_issue, have_write_lock, eip);
+}
+
+void
+CacheCntlrDonuts::processCommit(IntPtr address, PrL1PrL2DramDirectoryMSI::ShmemBatch& batch, ShmemPerfModel::Thread_t thread_num)
 {
 //   if (m_writebuffer_enabled)
 //   {
@@ -123,23 +381,40 @@ CacheCntlrDonuts::processCommit(IntPtr address, Byte* data_buf)
 //      auto latency = m_writebuffer_cntlr->insert(address, 0, nullptr, getCacheBlockSize(), ShmemPerfModel::_USER_THREAD, cache_block->getEpochID());
 //      getMemoryManager()->incrElapsedTime(latency, ShmemPerfModel::_USER_THREAD);
 //   }
-   sendMsgTo(PrL1PrL2DramDirectoryMSI::ShmemMsg::COMMIT, MemComponent::TAG_DIR, address, nullptr);
-   updateCacheBlock(address, CacheState::SHARED, Transition::COHERENCY, data_buf, ShmemPerfModel::_USER_THREAD);
+   Byte data_buf[getCacheBlockSize()];
+   updateCacheBlock(address, CacheState::SHARED, Transition::COHERENCY, data_buf, thread_num);
+   batch.add(address, data_buf);
 }
+
 void
-CacheCntlrDonuts::processPersist(IntPtr address, Byte* data_buf)
+CacheCntlrDonuts::processPersist(const PrL1PrL2DramDirectoryMSI::ShmemBatch& batch, ShmemPerfModel::Thread_t thread_num)
 {
-   sendMsgTo(PrL1PrL2DramDirectoryMSI::ShmemMsg::PERSIST, MemComponent::TAG_DIR, address, data_buf);
+   sendBatchTo(PrL1PrL2DramDirectoryMSI::ShmemMsg::COMMIT, MemComponent::TAG_DIR, batch, thread_num);
+   sendBatchTo(PrL1PrL2DramDirectoryMSI::ShmemMsg::PERSIST, MemComponent::TAG_DIR, batch, thread_num);
 }
 
 void
-CacheCntlrDonuts::sendMsgTo(PrL1PrL2DramDirectoryMSI::ShmemMsg::msg_t msg_type, MemComponent::component_t receiver_mem_component,
-                            IntPtr address, Byte* data_buf)
+CacheCntlrDonuts::sendBatchTo(PrL1PrL2DramDirectoryMSI::ShmemMsg::msg_t msg_type, MemComponent::component_t receiver_mem_component,
+                              const PrL1PrL2DramDirectoryMSI::ShmemBatch& batch, ShmemPerfModel::Thread_t thread_num)
 {
+   // All lines of a batch share the same home
+   std::vector<Byte> buf = batch.makeBuf(msg_type == PrL1PrL2DramDirectoryMSI::ShmemMsg::PERSIST);
    getMemoryManager()->sendMsg(msg_type,MemComponent::LAST_LEVEL_CACHE, receiver_mem_component,
-                               m_core_id_master, getHome(address), /* requester and receiver */
-                               address, data_buf, data_buf != nullptr ? getCacheBlockSize() : 0,
-                               HitWhere::UNKNOWN, &m_dummy_shmem_perf, ShmemPerfModel::_USER_THREAD);
+                               m_core_id_master, getHome(batch.front()), /* requester and receiver */
+                               batch.front(), buf.data(), buf.size(),
+                               HitWhere::UNKNOWN, &m_dummy_shmem_perf, thread_num);
+}
+
+CacheCntlrDonuts::CheckpointMode
+CacheCntlrDonuts::getCheckpointMode()
+{
+   const String param = "donuts/checkpoint_mode";
+   const String value = Sim()->getCfg()->hasKey(param) ? Sim()->getCfg()->getString(param) : "sync";
+
+   if (value == "sync") return CheckpointMode::SYNC;
+   if (value == "async") return CheckpointMode::ASYNC;
+
+   LOG_PRINT_ERROR("Invalid checkpoint mode %s, must be sync or async", value.c_str());
 }
 
 CacheCntlrDonuts::PersistencePolicy
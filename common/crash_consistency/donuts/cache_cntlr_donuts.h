@@ -2,6 +2,12 @@
 
 #include "cache_cntlr.h"
 #include "epoch_cntlr.h"
+#include "persist_scheduler.h"
+#include "shmem_batch.h"
+#include "lock.h"
+
+#include <atomic>
+#include <unordered_map>
 
 namespace ParametricDramDirectoryMSI
 {
@@ -16,6 +22,11 @@ public:
       BALANCED
    };
 
+   enum class CheckpointMode {
+      SYNC,    // The core waits until every line of the checkpoint is persisted
+      ASYNC    // The lines drain in the background, only writes to lines still in flight wait
+   };
+
    CacheCntlrDonuts(MemComponent::component_t mem_component,
                     String name,
                     core_id_t core_id,
@@ -26,39 +37,63 @@ public:
                     UInt32 cache_block_size,
                     CacheParameters& cache_params,
                     ShmemPerfModel* shmem_perf_model,
-                    bool is_last_level_cache,
-                    EpochCntlr* epoch_cntlr);
+                    bool is_last_level_cache);
 
    ~CacheCntlrDonuts() override;
 
    void checkpoint(CheckpointReason checkpoint_reason, UInt32 evicted_set_index) override;
 
+protected:
+
+   HitWhere::where_t processShmemReqFromPrevCache(CacheCntlr* requester, Core::mem_op_t mem_op_type, IntPtr address, bool modeled, bool count,
+                                                  Prefetch::prefetch_type_t isPrefetch, SubsecondTime t_issue, bool have_write_lock, IntPtr eip) override;
+
 private:
 
-   EpochCntlr *m_epoch_cntlr;
+   EpochCntlr *m_epoch_cntlr;              // Epochs of the domain of this LLC (nullptr on the other levels)
    PersistencePolicy m_persistence_policy;
+   CheckpointMode m_checkpoint_mode;
+   CacheCntlrDonuts *m_donuts_master;      // LLC controller of the master core, owns the checkpoint state
+   PersistScheduler *m_persist_scheduler;  // Owned by the master
+
+   // Master only: lines of the asynchronous checkpoints not persisted yet, and their persist time
+   Lock m_checkpoint_lock;
+   std::unordered_map<IntPtr, SubsecondTime> m_pending;
+
+   // Master only: set by the epoch timer, the periodic checkpoint runs on the next LLC access of the domain
+   std::atomic<bool> m_timeout_expired;
+   std::atomic<bool> m_timeout_ins_expired;
+
+   UInt64 m_coordinated_checkpoints;
+   SubsecondTime m_checkpoint_stall_time;
+   UInt64 m_pending_write_stalls;
+   SubsecondTime m_pending_write_stall_time;
+
+   void addDirtyBlocks(std::vector<IntPtr>& dirty_blocks, UInt32 set_index) const;
+   std::vector<IntPtr> selectDirtyBlocks(UInt32 evicted_set_index) const;
 
-   void addAllDirtyBlocks(std::queue<CacheBlockInfo*>& dirty_blocks, UInt32 set_index) const;
-   std::queue<CacheBlockInfo*> selectDirtyBlocks(UInt32 evicted_set_index) const;
+   void processCommit(IntPtr address, PrL1PrL2DramDirectoryMSI::ShmemBatch& batch, ShmemPerfModel::Thread_t thread_num);
+   void processPersist(const PrL1PrL2DramDirectoryMSI::ShmemBatch& batch, ShmemPerfModel::Thread_t thread_num);
 
-   void processCommit(IntPtr address, Byte* data_buf);
-   void processPersist(IntPtr address, Byte* data_buf);
+   void trackPending(const std::vector<PrL1PrL2DramDirectoryMSI::ShmemBatch>& batches, const std::vector<SubsecondTime>& t_persisted, SubsecondTime t_now);
+   void waitForPersist(IntPtr address);
 
-   void sendMsgTo(PrL1PrL2DramDirectoryMSI::ShmemMsg::msg_t msg_type, MemComponent::component_t receiver_mem_component, IntPtr address, Byte* data_buf);
+   void sendBatchTo(PrL1PrL2DramDirectoryMSI::ShmemMsg::msg_t msg_type, MemComponent::component_t receiver_mem_component, const PrL1PrL2DramDirectoryMSI::ShmemBatch& batch, ShmemPerfModel::Thread_t thread_num);
 
-   // Used to periodic checkpoints
-   static SInt64 _checkpoint_timeout(const UInt64 arg, const UInt64 val) {
-      reinterpret_cast<CacheCntlrDonuts *>(arg)->checkpoint(CheckpointReason::PERIODIC_TIME, 0);
-      return 0;
-   }
+   // thread_num: the thread doing the checkpoint (the sim thread when an LLC fill from a directory reply triggered it),
+   // its time is the start of the checkpoint and is charged the stall of a synchronous one
+   void checkpointLocked(CheckpointReason checkpoint_reason, UInt32 evicted_set_index, ShmemPerfModel::Thread_t thread_num);
+   void catchUp();
+   void checkpointExpired();
+   void advanceIdleSlices(SubsecondTime t_now);
+   void skipIdleEpochs(SubsecondTime t_now);
 
-   // Used to periodic checkpoints
-   static SInt64 _checkpoint_instr(const UInt64 arg, const UInt64 val) {
-      reinterpret_cast<CacheCntlrDonuts *>(arg)->checkpoint(CheckpointReason::PERIODIC_INSTRUCTIONS, 0);
-      return 0;
-   }
+   // Epoch timer events (master only)
+   static SInt64 _checkpoint_timeout(UInt64 arg, UInt64 val);
+   static SInt64 _checkpoint_instr(UInt64 arg, UInt64 val);
 
    static PersistencePolicy getPersistencePolicy();
+   static CheckpointMode getCheckpointMode();
 
    void printCache() const; // ONLY FOR DEBUG! //
 };
@@ -0,0 +1,183 @@
+#include "persist_scheduler.h"
+#include "memory_manager.h"
+#include "core_manager.h"
+#include "simulator.h"
+#include "config.hpp"
+#include "stats.h"
+#include "log.h"
+#include "utils.h"
+
+#include <unordered_map>
+
+PersistScheduler::PersistScheduler(const String& name, const core_id_t core_id, const UInt32 cache_block_size, AddressHomeLookup* home_lookup,
+                                   AddressHomeLookup* dram_home_lookup) :
+   m_core_id(core_id),
+   m_home_lookup(home_lookup),
+   m_dram_home_lookup(dram_home_lookup),
+   m_cache_block_size(cache_block_size),
+   m_log_block_size(floorLog2(cache_block_size)),
+   m_num_banks(Sim()->getCfg()->hasKey("donuts/banks_per_controller") ? Sim()->getCfg()->getInt("donuts/banks_per_controller") : 8),
+   m_queue_size(Sim()->getCfg()->hasKey("donuts/persist_queue_size") ? Sim()->getCfg()->getInt("donuts/persist_queue_size") : 16),
+   m_issue_time(SubsecondTime::Zero()),
+   m_engine_free(SubsecondTime::Zero()),
+   m_outstanding(m_queue_size, SubsecondTime::Zero()),
+   m_outstanding_head(0),
+   m_dram_perf_models(Config::getSingleton()->getTotalCores(), nullptr),
+   m_writes(Config::getSingleton()->getTotalCores(), 0),
+   m_checkpoints(0),
+   m_persisted_lines(0),
+   m_total_drain_time(SubsecondTime::Zero()),
+   m_max_drain_time(SubsecondTime::Zero()),
+   m_last_drain_time(SubsecondTime::Zero())
+{
+   LOG_ASSERT_ERROR(m_num_banks > 0, "donuts/banks_per_controller must be at least 1");
+   LOG_ASSERT_ERROR(m_queue_size > 0, "donuts/persist_queue_size must be at least 1");
+
+   // Rate at which the engine issues persists, unlimited by default
+   if (Sim()->getCfg()->hasKey("donuts/persist_bandwidth") && Sim()->getCfg()->getFloat("donuts/persist_bandwidth") > 0)
+   {
+      const ComponentBandwidth persist_bandwidth(8 * Sim()->getCfg()->getFloat("donuts/persist_bandwidth")); // Convert bytes to bits
+      m_issue_time = persist_bandwidth.getRoundedLatency(8 * cache_block_size); // bytes to bits
+   }
+
+   for (UInt32 i = 0; i < m_writes.size(); i++)
+      registerStatsMetric("donuts", i, "persist-writes", &m_writes[i]);
+
+   registerStatsMetric(name, core_id, "checkpoints", &m_checkpoints);
+   registerStatsMetric(name, core_id, "checkpoint-lines", &m_persisted_lines);
+   registerStatsMetric(name, core_id, "checkpoint-drain-time", &m_total_drain_time);
+   registerStatsMetric(name, core_id, "checkpoint-drain-time-max", &m_max_drain_time);
+   registerStatsMetric(name, core_id, "checkpoint-drain-time-last", &m_last_drain_time);
+}
+
+PersistScheduler::~PersistScheduler() = default;
+
+UInt32
+PersistScheduler::getBank(const IntPtr address) const
+{
+   // Consecutive lines of a controller are interleaved across its banks
+   return (m_home_lookup->getLinearAddress(address) >> m_log_block_size) % m_num_banks;
+}
+
+/**
+ * The controllers are created with the memory managers of their cores, some of them after this scheduler.
+ */
+DramPerfModel*
+PersistScheduler::getDramPerfModel(const core_id_t dram_node)
+{
+   DramPerfModel*& dram_perf_model = m_dram_perf_models.at(dram_node);
+   if (!dram_perf_model)
+   {
+      auto *memory_manager = dynamic_cast<ParametricDramDirectoryMSI::MemoryManager*>(Sim()->getCoreManager()->getCoreFromID(dram_node)->getMemoryManager());
+      LOG_ASSERT_ERROR(memory_manager && memory_manager->getDramCntlr(), "No memory controller at core %d", dram_node);
+      dram_perf_model = memory_manager->getDramCntlr()->getDramPerfModel();
+   }
+   return dram_perf_model;
+}
+
+/**
+ * Reorder lines[first..] so that consecutive write-backs go to different controllers (and, within a controller,
+ * to different banks). Lines are taken round-robin: one line per controller per round, rotating over the banks
+ * of each controller.
+ */
+void
+PersistScheduler::balance(std::vector<IntPtr>& lines, const UInt32 first) const
+{
+   if (lines.size() <= first + 1)
+      return;
+
+   struct Queue
+   {
+      std::vector<std::vector<IntPtr>> banks;
+      std::vector<UInt32> heads;
+      UInt32 next_bank = 0;
+      UInt64 remaining = 0;
+   };
+
+   std::vector<Queue> queues;
+   std::unordered_map<core_id_t, UInt32> queue_index;
+
+   for (UInt32 i = first; i < lines.size(); i++)
+   {
+      const core_id_t home = m_home_lookup->getHome(lines[i]);
+      auto it = queue_index.find(home);
+      if (it == queue_index.end())
+      {
+         it = queue_index.emplace(home, queues.size()).first;
+         queues.emplace_back();
+         queues.back().banks.resize(m_num_banks);
+         queues.back().heads.resize(m_num_banks, 0);
+      }
+      Queue& queue = queues[it->second];
+      queue.banks[getBank(lines[i])].push_back(lines[i]);
+      queue.remaining++;
+   }
+
+   UInt32 pos = first;
+   while (pos < lines.size())
+   {
+      for (auto& queue : queues)
+      {
+         if (queue.remaining == 0)
+            continue;
+
+         while (queue.heads[queue.next_bank] == queue.banks[queue.next_bank].size())
+            queue.next_bank = (queue.next_bank + 1) % m_num_banks;
+
+         lines[pos++] = queue.banks[queue.next_bank][queue.heads[queue.next_bank]++];
+         queue.next_bank = (queue.next_bank + 1) % m_num_banks;
+         queue.remaining--;
+      }
+   }
+}
+
+/**
+ * Model the drain of the PERSIST batches, in the order they are sent. At most m_queue_size persists can be
+ * outstanding, so a burst of slow writes to the same controller blocks the lines behind it. Every line costs
+ * what its controller charges for a write at its issue time (channel, banks or write pending queue, following
+ * perf_model/dram/type); the controller only writes the data of the PERSIST batch when it receives it.
+ */
+SubsecondTime
+PersistScheduler::drain(const std::vector<PrL1PrL2DramDirectoryMSI::ShmemBatch>& batches, const SubsecondTime t_start,
+                        std::vector<SubsecondTime>* t_persisted)
+{
+   SubsecondTime t_issue = getMax(t_start, m_engine_free), t_last = t_start;
+   UInt64 num_lines = 0;
+
+   if (t_persisted)
+      t_persisted->clear();
+
+   for (const auto& batch : batches)
+   {
+      for (const IntPtr address : batch.getAddresses())
+      {
+         const core_id_t dram_node = m_dram_home_lookup->getHome(address);
+
+         // Wait for a free slot in the persist queue
+         t_issue = getMax(t_issue, m_outstanding[m_outstanding_head]);
+
+         const SubsecondTime t_done = t_issue + getDramPerfModel(dram_node)->getAccessLatency(t_issue, m_cache_block_size, m_core_id, address,
+                                                                                              DramCntlrInterface::WRITE, &m_dummy_shmem_perf);
+         m_writes[dram_node]++;
+
+         m_outstanding[m_outstanding_head] = t_done;
+         m_outstanding_head = (m_outstanding_head + 1) % m_queue_size;
+         t_last = getMax(t_last, t_done);
+         if (t_persisted)
+            t_persisted->push_back(t_done);
+
+         t_issue += m_issue_time;
+         num_lines++;
+      }
+   }
+   m_engine_free = t_issue;
+
+   const SubsecondTime drain_time = t_last - t_start;
+   m_checkpoints++;
+   m_persisted_lines += num_lines;
+   m_total_drain_time += drain_time;
+   m_max_drain_time = getMax(m_max_drain_time, drain_time);
+   m_last_drain_time = drain_time;
+
+   return t_last;
+}
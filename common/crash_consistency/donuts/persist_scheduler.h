@@ -0,0 +1,62 @@
+#pragma once
+
+#include "fixed_types.h"
+#include "subsecond_time.h"
+#include "address_home_lookup.h"
+#include "shmem_batch.h"
+#include "dram_perf_model.h"
+#include "shmem_perf.h"
+
+#include <vector>
+
+/**
+ * Orders and times the write-backs of a checkpoint.
+ *
+ * The drain follows the PERSIST batches of the checkpoint, in the order they are sent: a persist engine at the
+ * LLC (optionally limited to donuts/persist_bandwidth) issues their lines with a bounded number of outstanding
+ * persists, and every line is timed by the performance model of its memory controller (e.g. perf_model/dram/type
+ * = nvm), the same model that the PERSIST batch reaches. The time from the start of the checkpoint to the last
+ * persist is the drain time of the checkpoint. The engine state carries over between checkpoints, so a
+ * checkpoint started while the previous one still drains queues behind it.
+ */
+class PersistScheduler
+{
+public:
+   PersistScheduler(const String& name, core_id_t core_id, UInt32 cache_block_size, AddressHomeLookup* home_lookup, AddressHomeLookup* dram_home_lookup);
+   ~PersistScheduler();
+
+   // Interleave the lines across the controllers and their banks, keeping the relative order of the lines of a bank
+   void balance(std::vector<IntPtr>& lines, UInt32 first = 0) const;
+
+   // Model the drain of the PERSIST batches of a checkpoint started at t_start, returns the time of the last persist.
+   // If t_persisted is given, it receives the persist time of every line, batch after batch.
+   SubsecondTime drain(const std::vector<PrL1PrL2DramDirectoryMSI::ShmemBatch>& batches, SubsecondTime t_start,
+                       std::vector<SubsecondTime>* t_persisted = nullptr);
+
+private:
+   const core_id_t m_core_id;
+   AddressHomeLookup* m_home_lookup;
+   AddressHomeLookup* m_dram_home_lookup;
+   const UInt32 m_cache_block_size;
+   const UInt32 m_log_block_size;
+   const UInt32 m_num_banks;
+   const UInt32 m_queue_size;
+   SubsecondTime m_issue_time;
+
+   SubsecondTime m_engine_free;
+   std::vector<SubsecondTime> m_outstanding; // Persist time of the last m_queue_size lines, oldest at m_outstanding_head
+   UInt32 m_outstanding_head;
+
+   std::vector<DramPerfModel*> m_dram_perf_models; // Indexed by the home core of each controller, looked up on first use
+   std::vector<UInt64> m_writes;
+   ShmemPerf m_dummy_shmem_perf;
+
+   UInt64 m_checkpoints;
+   UInt64 m_persisted_lines;
+   SubsecondTime m_total_drain_time;
+   SubsecondTime m_max_drain_time;
+   SubsecondTime m_last_drain_time;
+
+   [[nodiscard]] UInt32 getBank(IntPtr address) const;
+   DramPerfModel* getDramPerfModel(core_id_t dram_node);
+};
@@ -0,0 +1,97 @@
+#include "epoch_cntlr.h"
+#include "epoch_manager.h"
+#include "simulator.h"
+#include "core_manager.h"
+#include "core.h"
+#include "hooks_manager.h"
+#include "stats.h"
+#include "log.h"
+#include "utils.h"
+
+EpochCntlr::EpochCntlr(const core_id_t domain_id, const UInt32 num_cores) :
+   m_domain_id(domain_id),
+   m_num_cores(num_cores),
+   m_current_eid(0),
+   m_last_committed_eid(0),
+   m_last_persisted_eid(0),
+   m_start_time(SubsecondTime::Zero()),
+   m_start_instructions(0),
+   m_commit_start_time(SubsecondTime::Zero()),
+   m_commit_time(SubsecondTime::Zero()),
+   m_commit_instructions(0),
+   m_commit_dirty_lines(0),
+   m_committed(0),
+   m_persisted(0),
+   m_total_instructions(0),
+   m_total_dirty_lines(0),
+   m_total_duration(SubsecondTime::Zero()),
+   m_total_persist_latency(SubsecondTime::Zero()),
+   m_max_persist_latency(SubsecondTime::Zero())
+{
+   registerStatsMetric("epoch", domain_id, "current-eid", &m_current_eid);
+   registerStatsMetric("epoch", domain_id, "committed", &m_committed);
+   registerStatsMetric("epoch", domain_id, "persisted", &m_persisted);
+   registerStatsMetric("epoch", domain_id, "instructions", &m_total_instructions);
+   registerStatsMetric("epoch", domain_id, "dirty-lines", &m_total_dirty_lines);
+   registerStatsMetric("epoch", domain_id, "duration", &m_total_duration);
+   registerStatsMetric("epoch", domain_id, "persist-latency", &m_total_persist_latency);
+   registerStatsMetric("epoch", domain_id, "persist-latency-max", &m_max_persist_latency);
+}
+
+EpochCntlr::~EpochCntlr() = default;
+
+UInt64
+EpochCntlr::getInstructionCount() const
+{
+   UInt64 instructions = 0;
+   for (UInt32 i = 0; i < m_num_cores; i++)
+      instructions += Sim()->getCoreManager()->getCoreFromID(m_domain_id + i)->getInstructionCount();
+   return instructions;
+}
+
+void
+EpochCntlr::commit(const SubsecondTime now, const UInt64 dirty_lines)
+{
+   LOG_ASSERT_ERROR(m_committed == m_persisted, "Domain %d: epoch %lu committed before epoch %lu persisted",
+                    m_domain_id, m_current_eid, m_last_committed_eid);
+
+   const UInt64 instructions = getInstructionCount();
+
+   m_commit_start_time = m_start_time;
+   m_commit_time = getMax(now, m_start_time);
+   m_commit_instructions = instructions - m_start_instructions;
+   m_commit_dirty_lines = dirty_lines;
+
+   m_last_committed_eid = m_current_eid;
+   m_committed++;
+   m_total_instructions += m_commit_instructions;
+   m_total_dirty_lines += dirty_lines;
+   m_total_duration += m_commit_time - m_commit_start_time;
+
+   m_current_eid++;
+   m_start_time = m_commit_time;
+   m_start_instructions = instructions;
+   Sim()->getEpochManager()->updateGlobalSystemEID();
+
+   Sim()->getHooksManager()->callHooks(HookType::HOOK_EPOCH_END, m_last_committed_eid);
+   Sim()->getHooksManager()->callHooks(HookType::HOOK_EPOCH_START, m_current_eid);
+}
+
+void
+EpochCntlr::registerPersistedEID(const UInt64 eid, const SubsecondTime t_persisted)
+{
+   LOG_ASSERT_ERROR(hasCommitted() && eid == m_last_committed_eid && m_persisted < m_committed,
+                    "Domain %d: epoch %lu persisted but it is not the last committed epoch", m_domain_id, eid);
+
+   const SubsecondTime persist_latency = getMax(t_persisted, m_commit_time) - m_commit_time;
+
+   m_last_persisted_eid = eid;
+   m_persisted++;
+   m_total_persist_latency += persist_latency;
+   m_max_persist_latency = getMax(m_max_persist_latency, persist_latency);
+
+   Sim()->getStatsManager()->logEpoch(m_domain_id, eid, m_commit_start_time, m_commit_time, m_commit_time + persist_latency,
+                                      m_commit_instructions, m_commit_dirty_lines);
+
+   Sim()->getEpochManager()->updateGlobalPersistedEID();
+}
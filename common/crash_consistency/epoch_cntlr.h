@@ -1,12 +1,61 @@
- #pragma once
+#pragma once
 
- #include "core_manager.h"
+#include "fixed_types.h"
+#include "subsecond_time.h"
 
- class EpochCntlr
- {
- public:
+/**
+ * Epochs of a persistence domain (the cores sharing a last-level cache).
+ *
+ * An epoch ends when a checkpoint commits its dirty lines; the next epoch starts at once. The epoch is
+ * persisted when its last line reaches the persistence domain of the memory. Epoch IDs increase
+ * monotonically, starting at 0.
+ */
+class EpochCntlr
+{
+public:
+   EpochCntlr(core_id_t domain_id, UInt32 num_cores);
+   ~EpochCntlr();
 
-    EpochCntlr() {}
+   [[nodiscard]] core_id_t getDomainId() const { return m_domain_id; }
+   [[nodiscard]] UInt64 getCurrentEID() const { return m_current_eid; }
+   [[nodiscard]] UInt64 getLastCommittedEID() const { return m_last_committed_eid; }
+   [[nodiscard]] UInt64 getLastPersistedEID() const { return m_last_persisted_eid; }
+   [[nodiscard]] bool hasCommitted() const { return m_committed > 0; }
+   [[nodiscard]] bool hasPersisted() const { return m_persisted > 0; }
+   [[nodiscard]] SubsecondTime getStartTime() const { return m_start_time; }
+   // Instructions executed by the cores of the domain since the current epoch started
+   [[nodiscard]] UInt64 getEpochInstructions() const { return getInstructionCount() - m_start_instructions; }
 
-    virtual ~EpochCntlr() {}
- };
+   // End the current epoch at time now, with dirty_lines lines to persist, and start the next one
+   void commit(SubsecondTime now, UInt64 dirty_lines);
+   // The last line of a committed epoch was persisted at t_persisted (may lie ahead of the current time)
+   void registerPersistedEID(UInt64 eid, SubsecondTime t_persisted);
+
+private:
+   const core_id_t m_domain_id;
+   const UInt32 m_num_cores;
+
+   UInt64 m_current_eid;
+   UInt64 m_last_committed_eid;
+   UInt64 m_last_persisted_eid;
+
+   // Current epoch
+   SubsecondTime m_start_time;
+   UInt64 m_start_instructions;
+
+   // Committed epoch waiting for its persist
+   SubsecondTime m_commit_start_time;
+   SubsecondTime m_commit_time;
+   UInt64 m_commit_instructions;
+   UInt64 m_commit_dirty_lines;
+
+   UInt64 m_committed;
+   UInt64 m_persisted;
+   UInt64 m_total_instructions;
+   UInt64 m_total_dirty_lines;
+   SubsecondTime m_total_duration;
+   SubsecondTime m_total_persist_latency;
+   SubsecondTime m_max_persist_latency;
+
+   [[nodiscard]] UInt64 getInstructionCount() const;
+};
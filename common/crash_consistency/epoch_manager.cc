@@ -0,0 +1,151 @@
+#include "epoch_manager.h"
+#include "simulator.h"
+#include "hooks_manager.h"
+#include "config.h"
+#include "config.hpp"
+#include "log.h"
+
+#include <algorithm>
+
+UInt64 EpochManager::s_global_system_eid = 0;
+
+EpochManager::EpochManager() :
+  m_epoch_cntlrs(Config::getSingleton()->getTotalCores(), nullptr),
+  m_target_eid(0),
+  m_global_persisted(0),
+  m_timeout(getTimeout()),
+  m_timeout_ins(getTimeoutIns()),
+  m_persist_checker(PersistChecker::isEnabled() ? new PersistChecker(Sim()->getCfg()->getInt("perf_model/l1_icache/cache_block_size")) : nullptr)
+{
+  s_global_system_eid = 0;
+
+  if (m_timeout > SubsecondTime::Zero())
+    Sim()->getHooksManager()->registerHook(HookType::HOOK_PERIODIC, hookPeriodic, (UInt64) this);
+  if (m_timeout_ins > 0)
+    Sim()->getHooksManager()->registerHook(HookType::HOOK_PERIODIC_INS, hookPeriodicIns, (UInt64) this);
+}
+
+EpochManager::~EpochManager()
+{
+  for (auto *epoch_cntlr : m_domains)
+    delete epoch_cntlr;
+  delete m_persist_checker;
+}
+
+UInt64
+EpochManager::getGlobalSystemEID()
+{
+  return s_global_system_eid;
+}
+
+EpochCntlr *
+EpochManager::createEpochCntlr(const core_id_t domain_id, const UInt32 num_cores)
+{
+  ScopedLock sl(m_lock);
+
+  LOG_ASSERT_ERROR(domain_id + num_cores <= m_epoch_cntlrs.size(), "Epoch domain %d (%u cores) out of range", domain_id, num_cores);
+
+  auto *epoch_cntlr = new EpochCntlr(domain_id, num_cores);
+  for (UInt32 i = 0; i < num_cores; i++)
+  {
+    LOG_ASSERT_ERROR(m_epoch_cntlrs[domain_id + i] == nullptr, "Core %d already belongs to an epoch domain", domain_id + i);
+    m_epoch_cntlrs[domain_id + i] = epoch_cntlr;
+  }
+  m_domains.push_back(epoch_cntlr);
+
+  return epoch_cntlr;
+}
+
+EpochCntlr *
+EpochManager::getEpochCntlr(const core_id_t core_id) const
+{
+  return m_epoch_cntlrs.at(core_id);
+}
+
+void
+EpochManager::updateGlobalSystemEID()
+{
+  ScopedLock sl(m_lock);
+
+  UInt64 eid = UINT64_MAX, target_eid = 0;
+  for (const auto *epoch_cntlr : m_domains)
+  {
+    eid = std::min(eid, epoch_cntlr->getCurrentEID());
+    target_eid = std::max(target_eid, epoch_cntlr->getCurrentEID());
+  }
+  s_global_system_eid = m_domains.empty() ? 0 : eid;
+  m_target_eid.store(target_eid, std::memory_order_relaxed);
+}
+
+/**
+ * Raise HOOK_EPOCH_PERSISTED once per epoch, when the last domain persisted it.
+ */
+void
+EpochManager::updateGlobalPersistedEID()
+{
+  UInt64 first, last;
+  {
+    ScopedLock sl(m_lock);
+
+    UInt64 persisted = UINT64_MAX;
+    for (const auto *epoch_cntlr : m_domains)
+      persisted = std::min(persisted, epoch_cntlr->hasPersisted() ? epoch_cntlr->getLastPersistedEID() + 1 : 0);
+
+    first = m_global_persisted;
+    last = m_global_persisted = std::max(m_global_persisted, persisted);
+  }
+
+  for (UInt64 eid = first; eid < last; eid++)
+    Sim()->getHooksManager()->callHooks(HookType::HOOK_EPOCH_PERSISTED, eid);
+}
+
+bool
+EpochManager::hasTimedOut(const EpochCntlr *epoch_cntlr, const SubsecondTime now) const
+{
+  return m_timeout > SubsecondTime::Zero() && now >= epoch_cntlr->getStartTime() + m_timeout;
+}
+
+bool
+EpochManager::hasTimedOutIns(const EpochCntlr *epoch_cntlr) const
+{
+  return m_timeout_ins > 0 && epoch_cntlr->getEpochInstructions() >= m_timeout_ins;
+}
+
+/**
+ * The domains are only created while the memory hierarchy is built, so the timer reads them without the lock.
+ * One timeout event covers all the expired domains: each handler checks its own domain.
+ */
+SInt64
+EpochManager::hookPeriodic(const UInt64 self, const UInt64 time)
+{
+  const auto *epoch_manager = reinterpret_cast<EpochManager *>(self);
+  const SubsecondTime now(*reinterpret_cast<const subsecond_time_t *>(&time));
+
+  if (std::ranges::any_of(epoch_manager->m_domains, [&](const auto *epoch_cntlr) { return epoch_manager->hasTimedOut(epoch_cntlr, now); }))
+    Sim()->getHooksManager()->callHooks(HookType::HOOK_EPOCH_TIMEOUT, time);
+  return 0;
+}
+
+SInt64
+EpochManager::hookPeriodicIns(const UInt64 self, const UInt64 instructions)
+{
+  const auto *epoch_manager = reinterpret_cast<EpochManager *>(self);
+
+  if (std::ranges::any_of(epoch_manager->m_domains, [&](const auto *epoch_cntlr) { return epoch_manager->hasTimedOutIns(epoch_cntlr); }))
+    Sim()->getHooksManager()->callHooks(HookType::HOOK_EPOCH_TIMEOUT_INS, instructions);
+  return 0;
+}
+
+SubsecondTime
+EpochManager::getTimeout()
+{
+  const String param = "donuts/epoch_timeout";
+  return SubsecondTime::NS(Sim()->getCfg()->hasKey(param) ? Sim()->getCfg()->getInt(param) : 0);
+}
+
+UInt64
+EpochManager::getTimeoutIns()
+{
+  const String param = "donuts/epoch_timeout_ins";
+  return Sim()->getCfg()->hasKey(param) ? Sim()->getCfg()->getInt(param) : 0;
+}
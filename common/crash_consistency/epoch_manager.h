@@ -3,15 +3,77 @@
 
 #include "fixed_types.h"
 #include "epoch_cntlr.h"
+#include "persist_checker.h"
+#include "subsecond_time.h"
+#include "lock.h"
 
+#include <atomic>
+#include <vector>
+
+/**
+ * Owns the epoch controllers, one per persistence domain. A domain is created by the master controller
+ * of each last-level cache and covers the cores sharing it.
+ *
+ * With several LLC slices, a checkpoint in one domain raises the target epoch of the system, and every
+ * domain behind it catches up with its own checkpoint. An epoch is persisted in the system once every
+ * domain persisted it.
+ *
+ * The epoch timer raises HOOK_EPOCH_TIMEOUT (HOOK_EPOCH_TIMEOUT_INS) from HOOK_PERIODIC (HOOK_PERIODIC_INS)
+ * when an epoch is older than donuts/epoch_timeout nanoseconds (donuts/epoch_timeout_ins instructions).
+ */
 class EpochManager {
 public:
+  EpochManager();
+  ~EpochManager();
 
-  static UInt64 getGlobalSystemEID() { return 0; }
+  EpochManager(const EpochManager&) = delete;
+  EpochManager& operator=(const EpochManager&) = delete;
 
-  [[nodiscard]] EpochCntlr *getEpochCntlr(core_id_t core_id) const { return nullptr; }
-};
+  // Oldest epoch still open in the system
+  static UInt64 getGlobalSystemEID();
+
+  EpochCntlr *createEpochCntlr(core_id_t domain_id, UInt32 num_cores);
+  // Epoch controller of the domain of a core, nullptr if the core belongs to no domain
+  [[nodiscard]] EpochCntlr *getEpochCntlr(core_id_t core_id) const;
+  // Created while the memory hierarchy is built, fixed afterwards
+  [[nodiscard]] const std::vector<EpochCntlr*>& getDomains() const { return m_domains; }
+
+  // Highest epoch open in any domain, the domains behind it must checkpoint to reach it
+  [[nodiscard]] UInt64 getTargetEID() const { return m_target_eid.load(std::memory_order_relaxed); }
+  // Epochs persisted by every domain
+  [[nodiscard]] bool hasGlobalPersisted() const { return m_global_persisted > 0; }
+  [[nodiscard]] UInt64 getGlobalPersistedEID() const { return m_global_persisted - 1; }
+
+  void updateGlobalSystemEID();
+  void updateGlobalPersistedEID();
+
+  // nullptr unless donuts/checker/enabled
+  [[nodiscard]] PersistChecker *getPersistChecker() const { return m_persist_checker; }
+
+  // Whether the current epoch of a domain lasted for the timeout, always false if that timeout is disabled
+  [[nodiscard]] bool hasTimedOut(const EpochCntlr *epoch_cntlr, SubsecondTime now) const;
+  [[nodiscard]] bool hasTimedOutIns(const EpochCntlr *epoch_cntlr) const;
 
+private:
+  std::vector<EpochCntlr*> m_epoch_cntlrs; // Indexed by core
+  std::vector<EpochCntlr*> m_domains;
+  Lock m_lock;
 
+  std::atomic<UInt64> m_target_eid;
+  UInt64 m_global_persisted;      // Number of epochs persisted by every domain
+
+  const SubsecondTime m_timeout;  // Zero: disabled
+  const UInt64 m_timeout_ins;     // 0: disabled
+
+  PersistChecker *m_persist_checker;
+
+  static UInt64 s_global_system_eid;
+
+  static SubsecondTime getTimeout();
+  static UInt64 getTimeoutIns();
+
+  static SInt64 hookPeriodic(UInt64 self, UInt64 time);
+  static SInt64 hookPeriodicIns(UInt64 self, UInt64 instructions);
+};
 
 #endif //EPOCH_MANAGER_H
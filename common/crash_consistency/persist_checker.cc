@@ -0,0 +1,227 @@
+#include "persist_checker.h"
+#include "shmem_batch.h"
+#include "simulator.h"
+#include "hooks_manager.h"
+#include "epoch_manager.h"
+#include "stats.h"
+#include "config.hpp"
+#include "log.h"
+
+#include <cstring>
+
+PersistChecker::PersistChecker(const UInt32 line_size)
+   : m_line_size(line_size)
+   , m_crash_interval(getCrashInterval())
+   , m_expected(PAGE_SIZE, false)
+   , m_persisted(PAGE_SIZE, false)
+   , m_check_pending(false)
+   , m_check_eid(0)
+   , m_last_crash(SubsecondTime::Zero())
+   , m_mismatched_lines(0)
+   , m_checks(0)
+   , m_inconsistent_checks(0)
+   , m_max_mismatched_lines(0)
+   , m_pages_compared(0)
+{
+   LOG_ASSERT_ERROR(line_size <= PAGE_SIZE && PAGE_SIZE % line_size == 0, "Line size (%u) must divide the page size", line_size);
+
+   registerStatsMetric("persist-checker", 0, "checks", &m_checks);
+   registerStatsMetric("persist-checker", 0, "inconsistent-checks", &m_inconsistent_checks);
+   registerStatsMetric("persist-checker", 0, "mismatched-lines", &m_mismatched_lines);
+   registerStatsMetric("persist-checker", 0, "max-mismatched-lines", &m_max_mismatched_lines);
+   registerStatsMetric("persist-checker", 0, "pages-compared", &m_pages_compared);
+
+   Sim()->getHooksManager()->registerHook(HookType::HOOK_EPOCH_PERSISTED, hookEpochPersisted, (UInt64) this);
+   if (m_crash_interval > SubsecondTime::Zero())
+      Sim()->getHooksManager()->registerHook(HookType::HOOK_PERIODIC, hookPeriodic, (UInt64) this);
+}
+
+PersistChecker::~PersistChecker() = default;
+
+bool
+PersistChecker::isEnabled()
+{
+   return Sim()->getCfg()->getBoolDefault("donuts/checker/enabled", false);
+}
+
+void
+PersistChecker::writeLine(DramDataArena& image, const IntPtr address, const Byte* data)
+{
+   memcpy(image.get(address, m_line_size), data, m_line_size);
+   m_dirty_pages.insert(address & ~IntPtr(PAGE_SIZE - 1));
+}
+
+/**
+ * The lines of an epoch can reach the memory before its batches are committed here, so the count may go
+ * negative for a while.
+ */
+void
+PersistChecker::countOutstanding(const UInt64 eid, const SInt64 lines)
+{
+   auto it = m_outstanding_lines.emplace(eid, 0).first;
+   it->second += lines;
+   if (it->second == 0)
+      m_outstanding_lines.erase(it);
+}
+
+void
+PersistChecker::commitBatch(std::vector<Byte>&& batch_buf)
+{
+   ScopedLock sl(m_lock);
+   const UInt64 eid = PrL1PrL2DramDirectoryMSI::ShmemBatch::getEID(batch_buf.data());
+   countOutstanding(eid, PrL1PrL2DramDirectoryMSI::ShmemBatch::getSize(batch_buf.data()));
+   m_staged[eid].push_back(std::move(batch_buf));
+}
+
+void
+PersistChecker::persistBatch(const Byte* batch_buf)
+{
+   bool checked;
+   UInt64 eid, mismatched;
+   {
+      ScopedLock sl(m_lock);
+
+      const UInt64 count = PrL1PrL2DramDirectoryMSI::ShmemBatch::getSize(batch_buf);
+      for (UInt64 i = 0; i < count; i++)
+      {
+         writeLine(m_persisted, PrL1PrL2DramDirectoryMSI::ShmemBatch::getAddress(batch_buf, i),
+                   PrL1PrL2DramDirectoryMSI::ShmemBatch::getData(const_cast<Byte*>(batch_buf), i, m_line_size));
+      }
+      countOutstanding(PrL1PrL2DramDirectoryMSI::ShmemBatch::getEID(batch_buf), -SInt64(count));
+
+      checked = runPendingCheck();
+      eid = m_check_eid;
+      mismatched = m_mismatched_lines;
+   }
+   if (checked)
+      notifyCheck(eid, mismatched);
+}
+
+/**
+ * A crash at the last persisted epoch: bring the expected image up to it, and check as soon as the memory
+ * received all the lines of that epoch and of the previous ones.
+ */
+void
+PersistChecker::requestCheck(const UInt64 eid)
+{
+   bool checked;
+   UInt64 mismatched;
+   {
+      ScopedLock sl(m_lock);
+
+      while (!m_staged.empty() && m_staged.begin()->first <= eid)
+      {
+         for (const auto& batch_buf : m_staged.begin()->second)
+         {
+            const UInt64 count = PrL1PrL2DramDirectoryMSI::ShmemBatch::getSize(batch_buf.data());
+            for (UInt64 i = 0; i < count; i++)
+            {
+               writeLine(m_expected, PrL1PrL2DramDirectoryMSI::ShmemBatch::getAddress(batch_buf.data(), i),
+                         PrL1PrL2DramDirectoryMSI::ShmemBatch::getData(const_cast<Byte*>(batch_buf.data()), i, m_line_size));
+            }
+         }
+         m_staged.erase(m_staged.begin());
+      }
+
+      m_check_pending = true;
+      m_check_eid = eid;
+      checked = runPendingCheck();
+      mismatched = m_mismatched_lines;
+   }
+   if (checked)
+      notifyCheck(eid, mismatched);
+}
+
+bool
+PersistChecker::runPendingCheck()
+{
+   // Every epoch up to the checked one must be complete in memory
+   if (!m_check_pending || (!m_outstanding_lines.empty() && m_outstanding_lines.begin()->first <= m_check_eid))
+      return false;
+
+   for (const IntPtr page : m_dirty_pages)
+   {
+      const UInt32 mismatched = diffPage(page);
+      auto it = m_mismatched_pages.find(page);
+      const UInt32 previous = it == m_mismatched_pages.end() ? 0 : it->second;
+
+      m_mismatched_lines += mismatched;
+      m_mismatched_lines -= previous;
+      if (mismatched > 0)
+         m_mismatched_pages[page] = mismatched;
+      else if (it != m_mismatched_pages.end())
+         m_mismatched_pages.erase(it);
+   }
+   m_pages_compared += m_dirty_pages.size();
+   m_dirty_pages.clear();
+
+   m_check_pending = false;
+   m_checks++;
+   if (m_mismatched_lines > 0)
+      m_inconsistent_checks++;
+   m_max_mismatched_lines = std::max(m_max_mismatched_lines, m_mismatched_lines);
+
+   return true;
+}
+
+UInt32
+PersistChecker::diffPage(const IntPtr page)
+{
+   const Byte* expected = m_expected.peek(page, PAGE_SIZE);
+   const Byte* persisted = m_persisted.peek(page, PAGE_SIZE);
+   if (expected == nullptr && persisted == nullptr)
+      return 0;
+
+   // A page missing from one image holds zeros
+   static const Byte zeros[PAGE_SIZE] = {};
+   if (expected == nullptr)
+      expected = zeros;
+   if (persisted == nullptr)
+      persisted = zeros;
+
+   UInt32 mismatched = 0;
+   for (UInt32 offset = 0; offset < PAGE_SIZE; offset += m_line_size)
+   {
+      if (memcmp(expected + offset, persisted + offset, m_line_size) != 0)
+         mismatched++;
+   }
+   return mismatched;
+}
+
+void
+PersistChecker::notifyCheck(const UInt64 eid, const UInt64 mismatched)
+{
+   LOG_PRINT("Crash check at epoch %lu: %lu mismatched lines", eid, mismatched);
+   Sim()->getHooksManager()->callHooks(HookType::HOOK_CRASH_CHECK, mismatched);
+}
+
+SInt64
+PersistChecker::hookEpochPersisted(const UInt64 self, const UInt64 eid)
+{
+   reinterpret_cast<PersistChecker *>(self)->requestCheck(eid);
+   return 0;
+}
+
+SInt64
+PersistChecker::hookPeriodic(const UInt64 self, const UInt64 time)
+{
+   auto *checker = reinterpret_cast<PersistChecker *>(self);
+   const SubsecondTime now(*reinterpret_cast<const subsecond_time_t *>(&time));
+
+   if (now < checker->m_last_crash + checker->m_crash_interval)
+      return 0;
+   checker->m_last_crash = now;
+
+   // Crash now: the memory must hold the last epoch persisted in the system
+   const auto& epoch_manager = Sim()->getEpochManager();
+   if (epoch_manager->hasGlobalPersisted())
+      checker->requestCheck(epoch_manager->getGlobalPersistedEID());
+   return 0;
+}
+
+SubsecondTime
+PersistChecker::getCrashInterval()
+{
+   const String param = "donuts/checker/crash_interval";
+   return SubsecondTime::NS(Sim()->getCfg()->hasKey(param) ? Sim()->getCfg()->getInt(param) : 0);
+}
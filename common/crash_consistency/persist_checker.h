@@ -0,0 +1,85 @@
+#pragma once
+
+#include "fixed_types.h"
+#include "dram_data_arena.h"
+#include "lock.h"
+#include "subsecond_time.h"
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Checks that the NVM image matches the last persisted epoch at simulated crash points.
+ *
+ * Two shadow images are kept: the persisted image, written only by the PERSIST traffic reaching the memory
+ * controllers, and the expected image, made of the checkpoint batches of every epoch persisted in the system.
+ * A crash point is checked once the memory received every PERSIST line that the checkpoints of that epoch
+ * and of the previous ones sent, so that lines still in the network are not reported. Lines are counted per
+ * epoch: the lines of later epochs reaching the memory first do not make up for the missing ones.
+ *
+ * The diff is incremental: only the pages written in either image since the previous check are compared,
+ * and the pages that still differ are remembered with their number of mismatching lines.
+ *
+ * Crash points: every persisted epoch, and every donuts/checker/crash_interval nanoseconds if set.
+ * Every check raises HOOK_CRASH_CHECK with the number of mismatching lines.
+ */
+class PersistChecker
+{
+public:
+   explicit PersistChecker(UInt32 line_size);
+   ~PersistChecker();
+
+   PersistChecker(const PersistChecker&) = delete;
+   PersistChecker& operator=(const PersistChecker&) = delete;
+
+   static bool isEnabled();
+
+   // Checkpoint batch (ShmemBatch PERSIST payload) committed by a domain
+   void commitBatch(std::vector<Byte>&& batch_buf);
+   // PERSIST batch received by a memory controller
+   void persistBatch(const Byte* batch_buf);
+
+   [[nodiscard]] UInt64 getMismatchedLines() const { return m_mismatched_lines; }
+
+private:
+   static const UInt32 PAGE_SIZE = 4096;
+
+   const UInt32 m_line_size;
+   const SubsecondTime m_crash_interval; // Zero: only at the persisted epochs
+
+   DramDataArena m_expected;
+   DramDataArena m_persisted;
+   std::map<UInt64, std::vector<std::vector<Byte>>> m_staged; // Batches of the epochs not persisted yet
+
+   std::map<UInt64, SInt64> m_outstanding_lines; // PERSIST lines committed and not received yet, per epoch
+   bool m_check_pending;
+   UInt64 m_check_eid;
+   SubsecondTime m_last_crash;
+
+   std::unordered_set<IntPtr> m_dirty_pages;
+   std::unordered_map<IntPtr, UInt32> m_mismatched_pages;
+   UInt64 m_mismatched_lines;
+
+   UInt64 m_checks;
+   UInt64 m_inconsistent_checks;
+   UInt64 m_max_mismatched_lines;
+   UInt64 m_pages_compared;
+
+   Lock m_lock;
+
+   void requestCheck(UInt64 eid);
+   // Run the pending check if the memory received all the lines up to its epoch, returns whether it ran
+   // (call HOOK_CRASH_CHECK then)
+   bool runPendingCheck();
+   static void notifyCheck(UInt64 eid, UInt64 mismatched);
+   UInt32 diffPage(IntPtr page);
+   void writeLine(DramDataArena& image, IntPtr address, const Byte* data);
+   void countOutstanding(UInt64 eid, SInt64 lines);
+
+   static SubsecondTime getCrashInterval();
+
+   static SInt64 hookEpochPersisted(UInt64 self, UInt64 eid);
+   static SInt64 hookPeriodic(UInt64 self, UInt64 time);
+};
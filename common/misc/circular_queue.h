@@ -44,6 +44,7 @@ template <class T> class CircularQueue
       bool full(void) const;
       bool empty(void) const;
       UInt32 size(void) const;
+      void clear(void) { m_first = m_last; }
       iterator begin(void) { return iterator(*this, 0); }
       iterator end(void) { return iterator(*this, size()); }
       T& operator[](UInt32 idx) const { return m_queue[(m_last + idx) % m_size]; }
@@ -0,0 +1,52 @@
+#ifndef PROFILED_LOCK_H
+#define PROFILED_LOCK_H
+
+#include "fixed_types.h"
+#include "lock.h"
+#include "timer.h"
+
+/* Proxy for a lock that measures the host time spent waiting to acquire it.
+   Several proxies can share the same lock, e.g. one per thread or per user of a shared structure. */
+
+class ProfiledLock final : public BaseLock
+{
+public:
+   explicit ProfiledLock(BaseLock &lock)
+      : m_lock(lock)
+      , m_acquires(0)
+      , m_wait_time(0)
+   {}
+
+   void acquire() override
+   {
+      const UInt64 t_start = Timer::now();
+      m_lock.acquire();
+      account(t_start);
+   }
+
+   void acquire_read() override
+   {
+      const UInt64 t_start = Timer::now();
+      m_lock.acquire_read();
+      account(t_start);
+   }
+
+   void release() override { m_lock.release(); }
+   void release_read() override { m_lock.release_read(); }
+
+   void account(const UInt64 t_start)
+   {
+      __sync_fetch_and_add(&m_acquires, 1);
+      __sync_fetch_and_add(&m_wait_time, Timer::now() - t_start);
+   }
+
+   UInt64* getAcquires() { return &m_acquires; }
+   UInt64* getWaitTime() { return &m_wait_time; } // in nanoseconds
+
+private:
+   BaseLock &m_lock;
+   UInt64 m_acquires;
+   UInt64 m_wait_time;
+};
+
+#endif // PROFILED_LOCK_H
@@ -27,6 +27,7 @@ const char* db_create_stmts[] = {
    // Other users
    "CREATE TABLE `topology` (componentname TEXT, coreid INTEGER, masterid INTEGER);",
    "CREATE TABLE `event` (event INTEGER, time INTEGER, core INTEGER, thread INTEGER, value0 INTEGER, value1 INTEGER, description TEXT);",
+   "CREATE TABLE `epoch` (domain INTEGER, eid INTEGER, starttime INTEGER, endtime INTEGER, persisttime INTEGER, instructions INTEGER, dirtylines INTEGER);",
 };
 const char db_insert_stmt_name[] = "INSERT INTO `names` (nameid, objectname, metricname) VALUES (?, ?, ?);";
 const char db_insert_stmt_prefix[] = "INSERT INTO `prefixes` (prefixid, prefixname) VALUES (?, ?);";
@@ -188,6 +189,30 @@ StatsManager::registerMetric(StatsMetricBase *metric)
    }
 }
 
+void
+StatsManager::unregisterObject(String objectName)
+{
+   std::string _objectName(objectName.c_str());
+   StatsObjectList::iterator it1 = m_objects.find(_objectName);
+   if (it1 == m_objects.end())
+      return;
+
+   for (StatsMetricList::iterator it2 = it1->second.begin(); it2 != it1->second.end(); ++it2)
+      for(StatsIndexList::iterator it3 = it2->second.second.begin(); it3 != it2->second.second.end(); ++it3)
+         delete it3->second;
+   m_objects.erase(it1);
+
+   if (m_db)
+   {
+      sqlite3_stmt *stmt;
+      sqlite3_prepare(m_db, "DELETE FROM `names` WHERE objectname = ?;", -1, &stmt, NULL);
+      sqlite3_bind_text(stmt, 1, _objectName.c_str(), -1, SQLITE_TRANSIENT);
+      int res = sqlite3_step(stmt);
+      LOG_ASSERT_ERROR(res == SQLITE_DONE, "Error executing SQL statement: %s", sqlite3_errmsg(m_db));
+      sqlite3_finalize(stmt);
+   }
+}
+
 StatsMetricBase *
 StatsManager::getMetricObject(String objectName, UInt32 index, String metricName)
 {
@@ -234,6 +259,23 @@ StatsManager::logEvent(event_type_t event, SubsecondTime time, core_id_t core_id
    sqlite3_finalize(stmt);
 }
 
+void
+StatsManager::logEpoch(core_id_t domain_id, UInt64 eid, SubsecondTime start, SubsecondTime end, SubsecondTime persisted, UInt64 instructions, UInt64 dirty_lines)
+{
+   sqlite3_stmt *stmt;
+   sqlite3_prepare(m_db, "INSERT INTO epoch (domain, eid, starttime, endtime, persisttime, instructions, dirtylines) VALUES (?, ?, ?, ?, ?, ?, ?);", -1, &stmt, NULL);
+   sqlite3_bind_int(stmt, 1, domain_id);
+   sqlite3_bind_int64(stmt, 2, eid);
+   sqlite3_bind_int64(stmt, 3, start.getFS());
+   sqlite3_bind_int64(stmt, 4, end.getFS());
+   sqlite3_bind_int64(stmt, 5, persisted.getFS());
+   sqlite3_bind_int64(stmt, 6, instructions);
+   sqlite3_bind_int64(stmt, 7, dirty_lines);
+   int res = sqlite3_step(stmt);
+   LOG_ASSERT_ERROR(res == SQLITE_DONE, "Error executing SQL statement: %s", sqlite3_errmsg(m_db));
+   sqlite3_finalize(stmt);
+}
+
 StatHist &
 StatHist::operator += (StatHist & stat)
 {
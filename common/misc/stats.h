@@ -73,11 +73,14 @@ class StatsManager
       void init();
       void recordStats(String prefix);
       void registerMetric(StatsMetricBase *metric);
+      // Remove every metric of a short-lived object (before its counters are freed), together with their names
+      void unregisterObject(String objectName);
       StatsMetricBase *getMetricObject(String objectName, UInt32 index, String metricName);
       void logTopology(String component, core_id_t core_id, core_id_t master_id);
       void logMarker(SubsecondTime time, core_id_t core_id, thread_id_t thread_id, UInt64 value0, UInt64 value1, const char * description)
       { logEvent(EVENT_MARKER, time, core_id, thread_id, value0, value1, description); }
       void logEvent(event_type_t event, SubsecondTime time, core_id_t core_id, thread_id_t thread_id, UInt64 value0, UInt64 value1, const char * description);
+      void logEpoch(core_id_t domain_id, UInt64 eid, SubsecondTime start, SubsecondTime end, SubsecondTime persisted, UInt64 instructions, UInt64 dirty_lines);
 
    private:
       UInt64 m_keyid;
@@ -95,7 +95,7 @@ void Network::netPullFromTransport()
          // if this isn't a broadcast message, then we shouldn't process it further
          if (packet.receiver != NetPacket::BROADCAST)
          {
-            if (packet.length > 0)
+            if (packet.length > 0 && !packet.zero_copy)
                delete [] (Byte*) packet.data;
             continue;
          }
@@ -117,7 +117,8 @@ void Network::netPullFromTransport()
 
          callback(_callbackObjs[packet.type], packet);
 
-         if (packet.length > 0)
+         // The callback owns zero-copy data
+         if (packet.length > 0 && !packet.zero_copy)
             delete [] (Byte*) packet.data;
       }
 
@@ -158,6 +159,9 @@ SInt32 Network::netSend(NetPacket& packet)
    std::vector<NetworkModel::Hop> hopVec;
    model->routePacket(packet, hopVec);
 
+   // Zero-copy data has a single owner, so it cannot be delivered more than once
+   LOG_ASSERT_ERROR(!packet.zero_copy || hopVec.size() == 1, "Zero-copy packet routed to %u destinations", (UInt32) hopVec.size());
+
    Byte *buffer = packet.makeBuffer();
    SubsecondTime start_time = packet.time;
 
@@ -196,7 +200,14 @@ SInt32 Network::netSend(NetPacket& packet)
       buff_pkt->time = hopVec[i].time;
       buff_pkt->receiver = hopVec[i].final_dest;
 
-      _transport->send(hopVec[i].next_dest, buffer, packet.bufferSize());
+      // The last hop takes the buffer instead of a copy of it
+      if (i + 1 == hopVec.size())
+      {
+         _transport->sendOwned(hopVec[i].next_dest, buffer, packet.bufferSize());
+         buffer = NULL;
+      }
+      else
+         _transport->send(hopVec[i].next_dest, buffer, packet.bufferSize());
 
       LOG_PRINT("Sent packet");
    }
@@ -488,6 +499,7 @@ NetPacket::NetPacket()
    , receiver(INVALID_CORE_ID)
    , length(0)
    , data(0)
+   , zero_copy(false)
 {
 }
 
@@ -501,6 +513,7 @@ NetPacket::NetPacket(SubsecondTime t, PacketType ty, SInt32 s,
    , receiver(r)
    , length(l)
    , data(d)
+   , zero_copy(false)
 {
 }
 
@@ -510,7 +523,7 @@ NetPacket::NetPacket(Byte *buffer)
    memcpy(this, buffer, sizeof(*this));
 
    // LOG_ASSERT_ERROR(length > 0, "type(%u), sender(%i), receiver(%i), length(%u)", type, sender, receiver, length);
-   if (length > 0)
+   if (length > 0 && !zero_copy)
    {
       Byte* data_buffer = new Byte[length];
       memcpy(data_buffer, buffer + sizeof(*this), length);
@@ -525,7 +538,7 @@ NetPacket::NetPacket(Byte *buffer)
 // but I don't see this as a major issue.
 UInt32 NetPacket::bufferSize() const
 {
-   return (sizeof(*this) + length);
+   return (sizeof(*this) + (zero_copy ? 0 : length));
 }
 
 Byte* NetPacket::makeBuffer() const
@@ -536,7 +549,8 @@ Byte* NetPacket::makeBuffer() const
    Byte *buffer = new Byte[size];
 
    memcpy(buffer, this, sizeof(*this));
-   memcpy(buffer + sizeof(*this), data, length);
+   if (!zero_copy)
+      memcpy(buffer + sizeof(*this), data, length);
 
    return buffer;
 }
@@ -31,6 +31,9 @@ public:
    SInt32 receiver;
    UInt32 length;
    const void *data;
+   // data is an object handed over to the receiver by pointer, it is not serialized into the packet.
+   // Only valid within this process; length still gives the serialized size for the network models.
+   bool zero_copy;
 
    NetPacket();
    explicit NetPacket(Byte*);
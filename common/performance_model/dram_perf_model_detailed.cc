@@ -0,0 +1,179 @@
+#include "dram_perf_model_detailed.h"
+#include "simulator.h"
+#include "config.h"
+#include "config.hpp"
+#include "stats.h"
+#include "shmem_perf.h"
+#include "utils.h"
+
+DramPerfModelDetailed::DramPerfModelDetailed(core_id_t core_id,
+      UInt32 cache_block_size):
+   DramPerfModel(core_id, cache_block_size),
+   m_cache_block_size(cache_block_size),
+   m_num_channels(Sim()->getCfg()->getInt("perf_model/dram/detailed/channels")),
+   m_num_ranks(Sim()->getCfg()->getInt("perf_model/dram/detailed/ranks")),
+   m_num_banks(Sim()->getCfg()->getInt("perf_model/dram/detailed/banks")),
+   m_lines_per_row(Sim()->getCfg()->getInt("perf_model/dram/detailed/row_size") / cache_block_size),
+   m_open_page(Sim()->getCfg()->getString("perf_model/dram/detailed/page_policy") == "open"),
+   m_row_hit_cap(Sim()->getCfg()->getInt("perf_model/dram/detailed/row_hit_cap")),
+   m_channel_bandwidth(8 * Sim()->getCfg()->getFloat("perf_model/dram/per_controller_bandwidth") / Sim()->getCfg()->getInt("perf_model/dram/detailed/channels")), // Convert bytes to bits
+   m_row_hits(0),
+   m_row_misses(0),
+   m_row_conflicts(0),
+   m_total_bank_delay(SubsecondTime::Zero()),
+   m_total_read_queueing_delay(SubsecondTime::Zero()),
+   m_total_write_queueing_delay(SubsecondTime::Zero()),
+   m_total_access_latency(SubsecondTime::Zero())
+{
+   String page_policy = Sim()->getCfg()->getString("perf_model/dram/detailed/page_policy");
+   LOG_ASSERT_ERROR(page_policy == "open" || page_policy == "closed", "Invalid DRAM page policy %s (open or closed)", page_policy.c_str());
+   LOG_ASSERT_ERROR(m_num_channels > 0 && m_num_ranks > 0 && m_num_banks > 0, "DRAM channels, ranks and banks must be at least 1");
+   LOG_ASSERT_ERROR(m_lines_per_row > 0, "DRAM row size must be at least one cache block (%u bytes)", cache_block_size);
+   LOG_ASSERT_ERROR(m_row_hit_cap > 0, "perf_model/dram/detailed/row_hit_cap must be at least 1");
+
+   String profile = Sim()->getCfg()->getString("perf_model/dram/detailed/timing");
+   m_timings.tRCD = getTiming(profile, "tRCD");
+   m_timings.tCAS = getTiming(profile, "tCAS");
+   m_timings.tCWD = getTiming(profile, "tCWD");
+   m_timings.tRP = getTiming(profile, "tRP");
+   m_timings.tWR = getTiming(profile, "tWR");
+   m_timings.tRAS = getTiming(profile, "tRAS");
+
+   Bank idle = { false, 0, 0, SubsecondTime::Zero(), SubsecondTime::Zero(), false, 0, 0, SubsecondTime::Zero(), SubsecondTime::Zero() };
+   m_banks.resize(m_num_channels * m_num_ranks * m_num_banks, idle);
+
+   m_channel_queue_models.resize(m_num_channels, NULL);
+   if (Sim()->getCfg()->getBool("perf_model/dram/queue_model/enabled"))
+   {
+      for (UInt32 channel = 0; channel < m_num_channels; ++channel)
+         m_channel_queue_models[channel] = QueueModel::create("dram-queue-channel" + itostr(channel), core_id, Sim()->getCfg()->getString("perf_model/dram/queue_model/type"),
+                                                              m_channel_bandwidth.getRoundedLatency(8 * cache_block_size)); // bytes to bits
+   }
+
+   registerStatsMetric("dram", core_id, "total-access-latency", &m_total_access_latency);
+   registerStatsMetric("dram", core_id, "total-read-queueing-delay", &m_total_read_queueing_delay);
+   registerStatsMetric("dram", core_id, "total-write-queueing-delay", &m_total_write_queueing_delay);
+   registerStatsMetric("dram", core_id, "total-bank-delay", &m_total_bank_delay);
+   registerStatsMetric("dram", core_id, "row-hits", &m_row_hits);
+   registerStatsMetric("dram", core_id, "row-misses", &m_row_misses);
+   registerStatsMetric("dram", core_id, "row-conflicts", &m_row_conflicts);
+}
+
+DramPerfModelDetailed::~DramPerfModelDetailed()
+{
+   for (QueueModel *queue_model : m_channel_queue_models)
+      delete queue_model;
+}
+
+SubsecondTime
+DramPerfModelDetailed::getTiming(const String &profile, const String &name)
+{
+   return SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("perf_model/dram/detailed/" + profile + "/" + name))); // Operate in fs for higher precision before converting to uint64_t/SubsecondTime
+}
+
+SubsecondTime
+DramPerfModelDetailed::getAccessLatency(SubsecondTime pkt_time, UInt64 pkt_size, core_id_t requester, IntPtr address, DramCntlrInterface::access_t access_type, ShmemPerf *perf)
+{
+   // pkt_size is in 'Bytes'
+   // m_channel_bandwidth is in 'Bits per clock cycle'
+   if ((!m_enabled) ||
+         (requester >= (core_id_t) Config::getSingleton()->getApplicationCores()))
+   {
+      return SubsecondTime::Zero();
+   }
+
+   // row:rank:bank:channel:column
+   UInt64 index = address / m_cache_block_size / m_lines_per_row;
+   UInt32 channel = index % m_num_channels; index /= m_num_channels;
+   UInt32 bank_id = index % m_num_banks; index /= m_num_banks;
+   UInt32 rank = index % m_num_ranks;
+   UInt64 row = index / m_num_ranks;
+   Bank &bank = m_banks[(channel * m_num_ranks + rank) * m_num_banks + bank_id];
+
+   bool is_write = access_type == DramCntlrInterface::WRITE;
+   SubsecondTime burst_time = m_channel_bandwidth.getRoundedLatency(8 * pkt_size); // bytes to bits
+   SubsecondTime t_col;
+
+   if (m_open_page && bank.open && bank.row == row)
+   {
+      t_col = getMax(pkt_time, bank.next_col);
+      bank.next_col = t_col + burst_time;
+      bank.hits++;
+      m_row_hits++;
+   }
+   else if (m_open_page && bank.prev_valid && bank.prev_row == row && bank.prev_hits < m_row_hit_cap
+            && getMax(pkt_time, bank.prev_next_col) + burst_time <= bank.prev_close)
+   {
+      // FR-FCFS: this hit was ready before the row switch, it goes in before the precharge
+      // (up to row_hit_cap hits per row, so the request that switched rows is not starved)
+      t_col = getMax(pkt_time, bank.prev_next_col);
+      bank.prev_next_col = t_col + burst_time;
+      bank.prev_hits++;
+      m_row_hits++;
+   }
+   else
+   {
+      SubsecondTime t_act;
+      if (bank.open)
+      {
+         SubsecondTime t_pre = getMax(pkt_time, bank.next_pre);
+         bank.prev_valid = true;
+         bank.prev_row = bank.row;
+         bank.prev_hits = bank.hits;
+         bank.prev_close = t_pre;
+         bank.prev_next_col = bank.next_col;
+         t_act = t_pre + m_timings.tRP;
+         m_row_conflicts++;
+      }
+      else
+      {
+         t_act = getMax(pkt_time, bank.next_pre);
+         m_row_misses++;
+      }
+
+      t_col = t_act + m_timings.tRCD;
+      bank.open = true;
+      bank.row = row;
+      bank.hits = 1;
+      bank.next_col = t_col + burst_time;
+      bank.next_pre = t_act + m_timings.tRAS;
+   }
+
+   // Data burst on the channel
+   SubsecondTime t_data = t_col + (is_write ? m_timings.tCWD : m_timings.tCAS);
+   SubsecondTime bus_delay = m_channel_queue_models[channel]
+                           ? m_channel_queue_models[channel]->computeQueueDelay(t_data, burst_time, requester)
+                           : SubsecondTime::Zero();
+   SubsecondTime t_done = t_data + bus_delay + burst_time;
+
+   // Write recovery before the row can be precharged, reads only need their column command issued
+   if (is_write)
+      bank.next_pre = getMax(bank.next_pre, t_done + m_timings.tWR);
+   else
+      bank.next_pre = getMax(bank.next_pre, t_col + burst_time);
+
+   if (!m_open_page)
+   {
+      bank.open = false;
+      bank.next_pre += m_timings.tRP;
+   }
+
+   SubsecondTime access_latency = t_done - pkt_time;
+   SubsecondTime bank_delay = t_col - pkt_time;
+
+   perf->updateTime(pkt_time);
+   perf->updateTime(t_col, ShmemPerf::DRAM_QUEUE);
+   perf->updateTime(t_data, ShmemPerf::DRAM_DEVICE);
+   perf->updateTime(t_done, ShmemPerf::DRAM_BUS);
+
+   // Update Memory Counters
+   m_num_accesses ++;
+   m_total_access_latency += access_latency;
+   m_total_bank_delay += bank_delay;
+   if (is_write)
+      m_total_write_queueing_delay += bus_delay;
+   else
+      m_total_read_queueing_delay += bus_delay;
+
+   return access_latency;
+}
@@ -0,0 +1,82 @@
+#ifndef __DRAM_PERF_MODEL_DETAILED_H__
+#define __DRAM_PERF_MODEL_DETAILED_H__
+
+#include "dram_perf_model.h"
+#include "queue_model.h"
+#include "fixed_types.h"
+#include "subsecond_time.h"
+#include "dram_cntlr_interface.h"
+
+#include <vector>
+
+// Channel/rank/bank DRAM controller:
+// - addresses map to row:rank:bank:channel:column, every bank keeps its open row and the earliest time of its
+//   next column and precharge/activate commands, so an access costs O(1) instead of a cycle-by-cycle simulation;
+// - open page policy keeps the row open for the next hit, closed page policy precharges after every access;
+// - FR-FCFS: row hits go ahead of the row switch that follows them, including hits simulated after the switch
+//   but whose timestamp falls before it; row_hit_cap only bounds the hits served ahead of a waiting switch, hits
+//   with no other row pending always stay on the open row;
+// - the data bus of every channel is a queue model (perf_model/dram/queue_model/type) occupied for one burst;
+// - timings (tRCD, tCAS, tCWD, tRP, tWR, tRAS) come from a profile, e.g. ddr4 or nvm with slow array reads
+//   (tRCD) and writes (tWR), so NVM experiments get the read/write asymmetry from the same bank model.
+class DramPerfModelDetailed : public DramPerfModel
+{
+   private:
+      struct Timings
+      {
+         SubsecondTime tRCD;  // Activate to column command
+         SubsecondTime tCAS;  // Read column command to data
+         SubsecondTime tCWD;  // Write column command to data
+         SubsecondTime tRP;   // Precharge to activate
+         SubsecondTime tWR;   // End of write data to precharge
+         SubsecondTime tRAS;  // Activate to precharge
+      };
+
+      struct Bank
+      {
+         bool open;
+         UInt64 row;
+         UInt32 hits;               // Row hits since the row was opened
+         SubsecondTime next_col;    // Earliest column command
+         SubsecondTime next_pre;    // Earliest precharge if open, activate if closed
+         // Row closed by the last switch, for the hits that FR-FCFS would have served before it
+         bool prev_valid;
+         UInt64 prev_row;
+         UInt32 prev_hits;          // Row hits of that row, including those moved ahead of the switch
+         SubsecondTime prev_close;
+         SubsecondTime prev_next_col;
+      };
+
+      const UInt32 m_cache_block_size;
+      const UInt32 m_num_channels;
+      const UInt32 m_num_ranks;
+      const UInt32 m_num_banks;
+      const UInt32 m_lines_per_row;
+      const bool m_open_page;
+      const UInt32 m_row_hit_cap;
+      Timings m_timings;
+
+      ComponentBandwidth m_channel_bandwidth;
+      std::vector<Bank> m_banks;
+      std::vector<QueueModel*> m_channel_queue_models;
+
+      UInt64 m_row_hits;
+      UInt64 m_row_misses;     // Bank was closed
+      UInt64 m_row_conflicts;  // Another row was open
+      SubsecondTime m_total_bank_delay;
+      SubsecondTime m_total_read_queueing_delay;
+      SubsecondTime m_total_write_queueing_delay;
+      SubsecondTime m_total_access_latency;
+
+      static SubsecondTime getTiming(const String &profile, const String &name);
+
+   public:
+      DramPerfModelDetailed(core_id_t core_id,
+            UInt32 cache_block_size);
+
+      ~DramPerfModelDetailed();
+
+      SubsecondTime getAccessLatency(SubsecondTime pkt_time, UInt64 pkt_size, core_id_t requester, IntPtr address, DramCntlrInterface::access_t access_type, ShmemPerf *perf);
+};
+
+#endif /* __DRAM_PERF_MODEL_DETAILED_H__ */
@@ -0,0 +1,126 @@
+#include "dram_perf_model_nvm.h"
+#include "simulator.h"
+#include "config.h"
+#include "config.hpp"
+#include "stats.h"
+#include "shmem_perf.h"
+#include "utils.h"
+
+DramPerfModelNvm::DramPerfModelNvm(core_id_t core_id,
+      UInt32 cache_block_size):
+   DramPerfModel(core_id, cache_block_size),
+   m_queue_model(NULL),
+   m_dram_bandwidth(8 * Sim()->getCfg()->getFloat("perf_model/dram/per_controller_bandwidth")), // Convert bytes to bits
+   m_wpq(Sim()->getCfg()->getInt("perf_model/dram/nvm/wpq_size"), SubsecondTime::Zero()),
+   m_wpq_head(0),
+   m_media_free(SubsecondTime::Zero()),
+   m_wpq_full(0),
+   m_total_read_queueing_delay(SubsecondTime::Zero()),
+   m_total_write_queueing_delay(SubsecondTime::Zero()),
+   m_total_wpq_stall_time(SubsecondTime::Zero()),
+   m_total_read_drain_delay(SubsecondTime::Zero()),
+   m_total_access_latency(SubsecondTime::Zero())
+{
+   LOG_ASSERT_ERROR(!m_wpq.empty(), "perf_model/dram/nvm/wpq_size must be at least 1");
+
+   m_read_latency = SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("perf_model/dram/nvm/read_latency"))); // Operate in fs for higher precision before converting to uint64_t/SubsecondTime
+   m_write_latency = SubsecondTime::FS() * static_cast<uint64_t>(TimeConverter<float>::NStoFS(Sim()->getCfg()->getFloat("perf_model/dram/nvm/write_latency")));
+
+   ComponentBandwidth write_bandwidth(8 * Sim()->getCfg()->getFloat("perf_model/dram/nvm/write_bandwidth")); // Convert bytes to bits
+   m_media_write_time = write_bandwidth.getRoundedLatency(8 * cache_block_size); // bytes to bits
+
+   if (Sim()->getCfg()->getBool("perf_model/dram/queue_model/enabled"))
+   {
+      m_queue_model = QueueModel::create("dram-queue", core_id, Sim()->getCfg()->getString("perf_model/dram/queue_model/type"),
+                                         m_dram_bandwidth.getRoundedLatency(8 * cache_block_size)); // bytes to bits
+   }
+
+   registerStatsMetric("dram", core_id, "total-access-latency", &m_total_access_latency);
+   registerStatsMetric("dram", core_id, "total-read-queueing-delay", &m_total_read_queueing_delay);
+   registerStatsMetric("dram", core_id, "total-write-queueing-delay", &m_total_write_queueing_delay);
+   registerStatsMetric("dram", core_id, "total-wpq-stall-time", &m_total_wpq_stall_time);
+   registerStatsMetric("dram", core_id, "total-read-drain-delay", &m_total_read_drain_delay);
+   registerStatsMetric("dram", core_id, "wpq-full", &m_wpq_full);
+}
+
+DramPerfModelNvm::~DramPerfModelNvm()
+{
+   if (m_queue_model)
+   {
+      delete m_queue_model;
+      m_queue_model = NULL;
+   }
+}
+
+SubsecondTime
+DramPerfModelNvm::getAccessLatency(SubsecondTime pkt_time, UInt64 pkt_size, core_id_t requester, IntPtr address, DramCntlrInterface::access_t access_type, ShmemPerf *perf)
+{
+   // pkt_size is in 'Bytes'
+   // m_dram_bandwidth is in 'Bits per clock cycle'
+   if ((!m_enabled) ||
+         (requester >= (core_id_t) Config::getSingleton()->getApplicationCores()))
+   {
+      return SubsecondTime::Zero();
+   }
+
+   SubsecondTime processing_time = m_dram_bandwidth.getRoundedLatency(8 * pkt_size); // bytes to bits
+
+   // Compute Queue Delay (shared channel)
+   SubsecondTime queue_delay;
+   if (m_queue_model)
+   {
+      queue_delay = m_queue_model->computeQueueDelay(pkt_time, processing_time, requester);
+   }
+   else
+   {
+      queue_delay = SubsecondTime::Zero();
+   }
+
+   SubsecondTime t_arrival = pkt_time + queue_delay + processing_time;
+   SubsecondTime access_latency;
+
+   perf->updateTime(pkt_time);
+   perf->updateTime(pkt_time + queue_delay, ShmemPerf::DRAM_QUEUE);
+   perf->updateTime(t_arrival, ShmemPerf::DRAM_BUS);
+
+   if (access_type == DramCntlrInterface::READ)
+   {
+      // Reads bypass the queued writes, unless the queue is full and must be drained first
+      SubsecondTime drain_delay = m_wpq[m_wpq_head] > t_arrival ? m_wpq[m_wpq_head] - t_arrival : SubsecondTime::Zero();
+
+      access_latency = queue_delay + processing_time + drain_delay + m_read_latency;
+
+      m_total_read_queueing_delay += queue_delay;
+      m_total_read_drain_delay += drain_delay;
+   }
+   else
+   {
+      // Wait for a free slot in the write pending queue, the oldest write leaves it when it reaches the media
+      SubsecondTime t_accept = getMax(t_arrival, m_wpq[m_wpq_head]);
+      if (t_accept > t_arrival)
+      {
+         m_wpq_full++;
+         m_total_wpq_stall_time += t_accept - t_arrival;
+      }
+
+      // Media writes are serialized at write_bandwidth
+      SubsecondTime t_media = getMax(t_accept, m_media_free);
+      m_media_free = t_media + m_media_write_time;
+
+      m_wpq[m_wpq_head] = t_media + getMax(m_media_write_time, m_write_latency);
+      m_wpq_head = (m_wpq_head + 1) % m_wpq.size();
+
+      // ADR: the write is persistent (and acknowledged) once accepted in the queue
+      access_latency = t_accept - pkt_time;
+
+      m_total_write_queueing_delay += queue_delay;
+   }
+
+   perf->updateTime(pkt_time + access_latency, ShmemPerf::DRAM_DEVICE);
+
+   // Update Memory Counters
+   m_num_accesses ++;
+   m_total_access_latency += access_latency;
+
+   return access_latency;
+}
@@ -0,0 +1,46 @@
+#ifndef __DRAM_PERF_MODEL_NVM_H__
+#define __DRAM_PERF_MODEL_NVM_H__
+
+#include "dram_perf_model.h"
+#include "queue_model.h"
+#include "fixed_types.h"
+#include "subsecond_time.h"
+#include "dram_cntlr_interface.h"
+
+#include <vector>
+
+// Non-volatile memory controller:
+// - reads and writes share the channel (per_controller_bandwidth) but have their own device latency;
+// - writes are acknowledged once they enter the write pending queue (ADR: the queue is in the persistence domain);
+// - the queue is drained to the media at write_bandwidth, so a write burst above that rate fills it,
+//   stalls new writes and forces reads to wait for a free slot.
+class DramPerfModelNvm : public DramPerfModel
+{
+   private:
+      QueueModel* m_queue_model;
+      SubsecondTime m_read_latency;
+      SubsecondTime m_write_latency;
+      ComponentBandwidth m_dram_bandwidth;
+      SubsecondTime m_media_write_time;
+
+      std::vector<SubsecondTime> m_wpq; // Media completion time of the last wpq_size writes, oldest at m_wpq_head
+      UInt32 m_wpq_head;
+      SubsecondTime m_media_free;
+
+      UInt64 m_wpq_full;
+      SubsecondTime m_total_read_queueing_delay;
+      SubsecondTime m_total_write_queueing_delay;
+      SubsecondTime m_total_wpq_stall_time;
+      SubsecondTime m_total_read_drain_delay;
+      SubsecondTime m_total_access_latency;
+
+   public:
+      DramPerfModelNvm(core_id_t core_id,
+            UInt32 cache_block_size);
+
+      ~DramPerfModelNvm();
+
+      SubsecondTime getAccessLatency(SubsecondTime pkt_time, UInt64 pkt_size, core_id_t requester, IntPtr address, DramCntlrInterface::access_t access_type, ShmemPerf *perf);
+};
+
+#endif /* __DRAM_PERF_MODEL_NVM_H__ */
@@ -12,6 +12,8 @@ Instruction::StaticInstructionCosts Instruction::m_instruction_costs;
 
 Instruction::Instruction(InstructionType type, OperandList &operands)
    : m_type(type)
+   , m_disas_func(NULL)
+   , m_disas_arg(NULL)
    , m_uops(NULL)
    , m_addr(0)
    , m_operands(operands)
@@ -20,6 +22,8 @@ Instruction::Instruction(InstructionType type, OperandList &operands)
 
 Instruction::Instruction(InstructionType type)
    : m_type(type)
+   , m_disas_func(NULL)
+   , m_disas_arg(NULL)
    , m_uops(NULL)
    , m_addr(0)
 {
@@ -68,8 +68,19 @@ public:
    void setAtomic(bool atomic) { m_atomic = atomic; }
    bool isAtomic() const { return m_atomic; }
 
-   void setDisassembly(String str) { m_disas = str; }
-   const String& getDisassembly(void) const { return m_disas; }
+   // The disassembly can also be produced on first use, it is only needed by tracing and debug output
+   typedef String (*DisassembleFunc)(const void *arg);
+   void setDisassembly(String str) { m_disas = str; m_disas_func = NULL; }
+   void setDisassembly(DisassembleFunc func, const void *arg) { m_disas_func = func; m_disas_arg = arg; }
+   const String& getDisassembly(void) const
+   {
+      if (m_disas_func)
+      {
+         m_disas = m_disas_func(m_disas_arg);
+         m_disas_func = NULL;
+      }
+      return m_disas;
+   }
 
    void setMicroOps(const std::vector<const MicroOp *> *uops)
    { m_uops = uops; }
@@ -82,7 +93,9 @@ private:
    static StaticInstructionCosts m_instruction_costs;
 
    InstructionType m_type;
-   String m_disas;
+   mutable String m_disas;
+   mutable DisassembleFunc m_disas_func;
+   const void *m_disas_arg;
 
    const std::vector<const MicroOp *> *m_uops;
 
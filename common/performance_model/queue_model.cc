@@ -5,6 +5,7 @@
 #include "queue_model_history_list.h"
 #include "queue_model_contention.h"
 #include "queue_model_windowed_mg1.h"
+#include "queue_model_interval_tree.h"
 #include "log.h"
 #include "config.hpp"
 
@@ -30,6 +31,12 @@ QueueModel::create(String name, UInt32 id, String model_type, SubsecondTime min_
    {
       return new QueueModelWindowedMG1(name, id);
    }
+   else if (model_type == "interval_tree")
+   {
+      UInt32 max_intervals = Sim()->getCfg()->getInt("queue_model/interval_tree/max_intervals");
+      bool analytical_model_enabled = Sim()->getCfg()->getBool("queue_model/interval_tree/analytical_model_enabled");
+      return new QueueModelIntervalTree(name, id, min_processing_time, max_intervals, analytical_model_enabled);
+   }
    else
    {
       LOG_PRINT_ERROR("Unrecognized Queue Model Type(%s)", model_type.c_str());
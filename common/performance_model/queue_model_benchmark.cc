@@ -0,0 +1,113 @@
+#include "queue_model_benchmark.h"
+#include "queue_model_interval_tree.h"
+#include "simulator.h"
+#include "stats.h"
+#include "config.hpp"
+#include "timer.h"
+#include "log.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+QueueModelBenchmark*
+QueueModelBenchmark::create()
+{
+   if (!Sim()->getCfg()->getBoolDefault("queue_model/benchmark/enabled", false))
+      return NULL;
+   return new QueueModelBenchmark();
+}
+
+QueueModelBenchmark::QueueModelBenchmark()
+   : m_num_requests(Sim()->getCfg()->getInt("queue_model/benchmark/requests"))
+   , m_utilization(Sim()->getCfg()->getFloat("queue_model/benchmark/utilization"))
+   , m_skew(SubsecondTime::NS(Sim()->getCfg()->getInt("queue_model/benchmark/skew")))
+   , m_processing_time(SubsecondTime::NS(Sim()->getCfg()->getInt("queue_model/benchmark/processing_time")))
+{
+   LOG_ASSERT_ERROR(m_num_requests > 0, "queue_model/benchmark/requests must be positive");
+   LOG_ASSERT_ERROR(m_utilization > 0 && m_utilization < 1, "queue_model/benchmark/utilization must be in (0, 1), got %f", m_utilization);
+   LOG_ASSERT_ERROR(m_processing_time > SubsecondTime::Zero(), "queue_model/benchmark/processing_time must be positive");
+}
+
+QueueModelBenchmark::~QueueModelBenchmark() = default;
+
+// The models register statistics under their name, which must not outlive them
+void
+QueueModelBenchmark::deleteModel(String name, QueueModel *model)
+{
+   Sim()->getStatsManager()->unregisterObject(name);
+   delete model;
+}
+
+void
+QueueModelBenchmark::generateRequests()
+{
+   // Fixed seed: every run (and every model) sees the same stream
+   std::mt19937_64 rng(12345);
+   std::exponential_distribution<double> interarrival(m_utilization / m_processing_time.getPS());
+   std::uniform_real_distribution<double> jitter(-double(m_skew.getPS()), double(m_skew.getPS()));
+
+   m_requests.resize(m_num_requests);
+   double arrival = 0;
+   for (Request &request : m_requests)
+   {
+      arrival += interarrival(rng);
+      double pkt_time = arrival + (m_skew > SubsecondTime::Zero() ? jitter(rng) : 0);
+      request.pkt_time = SubsecondTime::PS(UInt64(std::max(pkt_time, 0.)));
+      request.processing_time = m_processing_time;
+   }
+}
+
+UInt64
+QueueModelBenchmark::runModel(QueueModel *model, std::vector<SubsecondTime> &delays)
+{
+   delays.resize(m_requests.size());
+
+   UInt64 start = Timer::now();
+   for (UInt64 i = 0; i < m_requests.size(); i++)
+      delays[i] = model->computeQueueDelay(m_requests[i].pkt_time, m_requests[i].processing_time);
+   return Timer::now() - start;
+}
+
+void
+QueueModelBenchmark::run()
+{
+   generateRequests();
+
+   std::vector<SubsecondTime> reference, delays;
+   QueueModel *exact = new QueueModelIntervalTree("queue-bench-reference", 0, m_processing_time, m_num_requests + 2, false);
+   runModel(exact, reference);
+   deleteModel("queue-bench-reference", exact);
+
+   String filename = Sim()->getConfig()->formatOutputFileName("queue_model_bench.out");
+   FILE *fp = fopen(filename.c_str(), "w");
+   LOG_ASSERT_ERROR(fp != NULL, "Could not open %s", filename.c_str());
+
+   fprintf(fp, "# requests = %lu, utilization = %.2f, skew = %lu ns, processing_time = %lu ns\n",
+           m_num_requests, m_utilization, m_skew.getNS(), m_processing_time.getNS());
+   fprintf(fp, "%-16s %14s %16s %16s\n", "model", "Mreq/s", "mean-delay(ns)", "mean-abs-err(ns)");
+
+   const char *types[] = { "basic", "history_list", "contention", "windowed_mg1", "interval_tree" };
+   for (const char *type : types)
+   {
+      QueueModel *model = QueueModel::create(String("queue-bench-") + type, 0, type, m_processing_time);
+      UInt64 elapsed = runModel(model, delays);
+      deleteModel(String("queue-bench-") + type, model);
+
+      double total_delay = 0, total_error = 0;
+      for (UInt64 i = 0; i < m_requests.size(); i++)
+      {
+         total_delay += delays[i].getPS();
+         total_error += std::fabs(double(delays[i].getPS()) - double(reference[i].getPS()));
+      }
+
+      fprintf(fp, "%-16s %14.3f %16.3f %16.3f\n", type,
+              elapsed ? m_requests.size() * 1e3 / elapsed : 0.,
+              total_delay / m_requests.size() / 1e3,
+              total_error / m_requests.size() / 1e3);
+   }
+
+   fclose(fp);
+   m_requests.clear();
+   m_requests.shrink_to_fit();
+}
@@ -0,0 +1,48 @@
+#ifndef __QUEUE_MODEL_BENCHMARK_H__
+#define __QUEUE_MODEL_BENCHMARK_H__
+
+#include "queue_model.h"
+#include "fixed_types.h"
+#include "subsecond_time.h"
+
+#include <vector>
+
+/**
+ * Micro-benchmark of the queue models, run at startup when queue_model/benchmark/enabled is set.
+ *
+ * A synthetic stream of Poisson arrivals at the configured utilization, jittered by up to queue_model/benchmark/skew
+ * to mimic the out-of-order requests of loosely synchronized cores, is fed to every queue model type. For each one
+ * we report the throughput (requests per second of host time), the mean queue delay and the mean absolute error
+ * against an exact first-fit reference (an interval_tree model with unbounded history and no analytical fallback).
+ * Results go to queue_model_bench.out. The models are deleted, and their statistics unregistered, once the run is done.
+ */
+class QueueModelBenchmark
+{
+public:
+   static QueueModelBenchmark* create();
+   ~QueueModelBenchmark();
+
+   void run();
+
+private:
+   struct Request
+   {
+      SubsecondTime pkt_time;
+      SubsecondTime processing_time;
+   };
+
+   UInt64 m_num_requests;
+   double m_utilization;
+   SubsecondTime m_skew;
+   SubsecondTime m_processing_time;
+
+   std::vector<Request> m_requests;
+
+   QueueModelBenchmark();
+
+   void generateRequests();
+   UInt64 runModel(QueueModel *model, std::vector<SubsecondTime> &delays);
+   static void deleteModel(String name, QueueModel *model);
+};
+
+#endif /* __QUEUE_MODEL_BENCHMARK_H__ */
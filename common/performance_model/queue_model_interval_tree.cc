@@ -0,0 +1,242 @@
+#include "queue_model_interval_tree.h"
+#include "log.h"
+#include "stats.h"
+
+QueueModelIntervalTree::QueueModelIntervalTree(String name, UInt32 id, SubsecondTime min_processing_time, UInt32 max_intervals, bool analytical_model_enabled)
+   : m_min_processing_time(min_processing_time)
+   , m_max_intervals(max_intervals)
+   , m_analytical_model_enabled(analytical_model_enabled)
+   , m_pool(max_intervals + 2)
+   , m_free_nodes(NULL)
+   , m_root(NULL)
+   , m_num_intervals(0)
+   , m_seed(0x9e3779b9 ^ id)
+   , m_average_delay(MovingAverage<SubsecondTime>::createAvgType(MovingAverage<SubsecondTime>::ARITHMETIC_MEAN, max_intervals))
+   , m_total_requests(0)
+   , m_total_requests_using_analytical_model(0)
+   , m_utilized_time(SubsecondTime::Zero())
+   , m_total_queue_delay(SubsecondTime::Zero())
+{
+   LOG_ASSERT_ERROR(max_intervals >= 2, "Queue model %s: at least 2 free intervals are needed, got %u", name.c_str(), max_intervals);
+
+   // An insert adds at most one interval more than the eviction removes, so the pool never runs out
+   for (Node &node : m_pool)
+   {
+      node.left = m_free_nodes;
+      m_free_nodes = &node;
+   }
+
+   // Assumption: simulation time will not exceed 2^63
+   insertInterval(SubsecondTime::Zero(), SubsecondTime::FS() << 63);
+
+   registerStatsMetric(name, id, "num-requests", &m_total_requests);
+   registerStatsMetric(name, id, "num-requests-analytical", &m_total_requests_using_analytical_model);
+   registerStatsMetric(name, id, "total-time-used", &m_utilized_time);
+   registerStatsMetric(name, id, "total-queue-delay", &m_total_queue_delay);
+}
+
+QueueModelIntervalTree::~QueueModelIntervalTree()
+{
+   delete m_average_delay;
+}
+
+SubsecondTime
+QueueModelIntervalTree::computeQueueDelay(SubsecondTime pkt_time, SubsecondTime processing_time, core_id_t requester)
+{
+   SubsecondTime queue_delay;
+
+   // Requests older than all the history we kept: use the average delay
+   if (m_analytical_model_enabled && pkt_time + processing_time <= findOldest()->start)
+   {
+      m_total_requests_using_analytical_model++;
+      queue_delay = m_average_delay->compute();
+   }
+   else
+   {
+      queue_delay = computeUsingIntervalTree(pkt_time, processing_time);
+      m_average_delay->update(queue_delay);
+   }
+
+   m_utilized_time += processing_time;
+   m_total_requests++;
+   m_total_queue_delay += queue_delay;
+
+   return queue_delay;
+}
+
+SubsecondTime
+QueueModelIntervalTree::computeUsingIntervalTree(SubsecondTime pkt_time, SubsecondTime processing_time)
+{
+   SubsecondTime start, end, service_start;
+
+   Node *node = findContaining(pkt_time);
+   if (node && pkt_time + processing_time <= node->end)
+   {
+      service_start = pkt_time;
+   }
+   else
+   {
+      node = findFirstFit(m_root, pkt_time, processing_time);
+      LOG_ASSERT_ERROR(node != NULL, "No free interval of %s after %s", itostr(processing_time).c_str(), itostr(pkt_time).c_str());
+      service_start = node->start;
+   }
+   start = node->start;
+   end = node->end;
+
+   // Take [service_start, service_start + processing_time) out of the free interval, dropping unusable fragments
+   eraseInterval(start);
+   if (service_start - start >= m_min_processing_time && service_start > start)
+      insertInterval(start, service_start);
+   if (end - (service_start + processing_time) >= m_min_processing_time && end > service_start + processing_time)
+      insertInterval(service_start + processing_time, end);
+
+   if (m_num_intervals > m_max_intervals)
+      eraseInterval(findOldest()->start);
+
+   SubsecondTime queue_delay = service_start - pkt_time;
+   LOG_PRINT("IntervalTree: pkt_time(%s), processing_time(%s), queue_delay(%s)", itostr(pkt_time).c_str(), itostr(processing_time).c_str(), itostr(queue_delay).c_str());
+
+   return queue_delay;
+}
+
+void
+QueueModelIntervalTree::insertInterval(SubsecondTime start, SubsecondTime end)
+{
+   Node *node = m_free_nodes;
+   LOG_ASSERT_ERROR(node != NULL, "Free interval pool exhausted");
+   m_free_nodes = node->left;
+
+   node->start = start;
+   node->end = end;
+   node->priority = nextPriority();
+   node->left = node->right = NULL;
+   update(node);
+
+   Node *less, *greater_equal;
+   split(m_root, start, less, greater_equal);
+   m_root = merge(merge(less, node), greater_equal);
+   m_num_intervals++;
+}
+
+void
+QueueModelIntervalTree::eraseInterval(SubsecondTime start)
+{
+   // Cut out the nodes with start in [start, start + 1fs), there is exactly one as the intervals are disjoint
+   Node *less, *greater_equal, *node, *greater;
+   split(m_root, start, less, greater_equal);
+   split(greater_equal, start + SubsecondTime::FS(), node, greater);
+   LOG_ASSERT_ERROR(node != NULL && node->left == NULL && node->right == NULL, "No free interval starts at %s", itostr(start).c_str());
+   m_root = merge(less, greater);
+
+   node->left = m_free_nodes;
+   m_free_nodes = node;
+   m_num_intervals--;
+}
+
+QueueModelIntervalTree::Node*
+QueueModelIntervalTree::findContaining(SubsecondTime time) const
+{
+   // Last interval starting at or before time
+   Node *candidate = NULL;
+   for (Node *node = m_root; node; )
+   {
+      if (node->start <= time)
+      {
+         candidate = node;
+         node = node->right;
+      }
+      else
+         node = node->left;
+   }
+   return (candidate && time < candidate->end) ? candidate : NULL;
+}
+
+/**
+ * First interval starting after the given time that can hold length. Subtrees whose longest interval is
+ * too short are skipped, so only the search path of `after` is walked besides the successful descent.
+ */
+QueueModelIntervalTree::Node*
+QueueModelIntervalTree::findFirstFit(Node *node, SubsecondTime after, SubsecondTime length)
+{
+   if (node == NULL || node->max_length < length)
+      return NULL;
+   if (node->start <= after)
+      return findFirstFit(node->right, after, length);
+
+   if (Node *found = findFirstFit(node->left, after, length))
+      return found;
+   if (node->end - node->start >= length)
+      return node;
+   return findFirstFit(node->right, after, length);
+}
+
+const QueueModelIntervalTree::Node*
+QueueModelIntervalTree::findOldest() const
+{
+   const Node *node = m_root;
+   while (node->left)
+      node = node->left;
+   return node;
+}
+
+void
+QueueModelIntervalTree::update(Node *node)
+{
+   node->max_length = node->end - node->start;
+   if (node->left && node->left->max_length > node->max_length)
+      node->max_length = node->left->max_length;
+   if (node->right && node->right->max_length > node->max_length)
+      node->max_length = node->right->max_length;
+}
+
+void
+QueueModelIntervalTree::split(Node *node, SubsecondTime key, Node *&less, Node *&greater_equal)
+{
+   if (node == NULL)
+   {
+      less = greater_equal = NULL;
+   }
+   else if (node->start < key)
+   {
+      split(node->right, key, node->right, greater_equal);
+      less = node;
+      update(node);
+   }
+   else
+   {
+      split(node->left, key, less, node->left);
+      greater_equal = node;
+      update(node);
+   }
+}
+
+QueueModelIntervalTree::Node*
+QueueModelIntervalTree::merge(Node *a, Node *b)
+{
+   if (a == NULL)
+      return b;
+   if (b == NULL)
+      return a;
+   if (a->priority > b->priority)
+   {
+      a->right = merge(a->right, b);
+      update(a);
+      return a;
+   }
+   else
+   {
+      b->left = merge(a, b->left);
+      update(b);
+      return b;
+   }
+}
+
+UInt32
+QueueModelIntervalTree::nextPriority()
+{
+   // xorshift32: deterministic, so that simulations are reproducible
+   m_seed ^= m_seed << 13;
+   m_seed ^= m_seed >> 17;
+   m_seed ^= m_seed << 5;
+   return m_seed;
+}
@@ -0,0 +1,67 @@
+#ifndef __QUEUE_MODEL_INTERVAL_TREE_H__
+#define __QUEUE_MODEL_INTERVAL_TREE_H__
+
+#include "queue_model.h"
+#include "fixed_types.h"
+#include "moving_average.h"
+
+#include <vector>
+
+/**
+ * Exact gap-filling queue model: a request is served at the first free interval, at or after its arrival,
+ * that is long enough to hold it.
+ *
+ * The free intervals are kept in a treap ordered by start time, where every node also knows the longest
+ * interval of its subtree, so both the lookup and the update are O(log n). The nodes come from a pool of
+ * max_intervals entries: beyond that, the oldest free interval is dropped, and requests older than the
+ * oldest interval left get the average delay (as history_list does) when the analytical model is enabled.
+ */
+class QueueModelIntervalTree : public QueueModel
+{
+public:
+   QueueModelIntervalTree(String name, UInt32 id, SubsecondTime min_processing_time, UInt32 max_intervals, bool analytical_model_enabled);
+   ~QueueModelIntervalTree();
+
+   SubsecondTime computeQueueDelay(SubsecondTime pkt_time, SubsecondTime processing_time, core_id_t requester = INVALID_CORE_ID);
+
+private:
+   struct Node
+   {
+      SubsecondTime start, end;   // Free interval [start, end)
+      SubsecondTime max_length;   // Longest interval in this subtree
+      UInt32 priority;
+      Node *left, *right;
+   };
+
+   const SubsecondTime m_min_processing_time;
+   const UInt32 m_max_intervals;
+   const bool m_analytical_model_enabled;
+
+   std::vector<Node> m_pool;
+   Node *m_free_nodes;
+   Node *m_root;
+   UInt32 m_num_intervals;
+   UInt32 m_seed;
+
+   MovingAverage<SubsecondTime>* m_average_delay;
+
+   UInt64 m_total_requests;
+   UInt64 m_total_requests_using_analytical_model;
+   SubsecondTime m_utilized_time;
+   SubsecondTime m_total_queue_delay;
+
+   SubsecondTime computeUsingIntervalTree(SubsecondTime pkt_time, SubsecondTime processing_time);
+
+   void insertInterval(SubsecondTime start, SubsecondTime end);
+   void eraseInterval(SubsecondTime start);
+   Node* findContaining(SubsecondTime time) const;
+   static Node* findFirstFit(Node *node, SubsecondTime after, SubsecondTime length);
+   const Node* findOldest() const;
+
+   static void update(Node *node);
+   static void split(Node *node, SubsecondTime key, Node *&less, Node *&greater_equal);
+   static Node* merge(Node *a, Node *b);
+   UInt32 nextPriority();
+};
+
+#endif /* __QUEUE_MODEL_INTERVAL_TREE_H__ */
@@ -33,7 +33,7 @@ static SInt64 hookCallbackInt(const UInt64 pFunc, const UInt64 argument)
 
 static SInt64 hookCallbackSubsecondTime(const UInt64 pFunc, const UInt64 argument)
 {
-   const SubsecondTime time(*reinterpret_cast<subsecond_time_t*>(argument));
+   const SubsecondTime time(*reinterpret_cast<const subsecond_time_t*>(&argument));
    PyObject *pResult = HooksPy::callPythonFunction((PyObject *)pFunc, Py_BuildValue("(L)", time.getFS()));
    return hookCallbackResult(pResult);
 }
@@ -153,6 +153,7 @@ registerHook(PyObject *self, PyObject *args)
       case HookType::HOOK_EPOCH_END:         // Added by Kleber Kruger
       case HookType::HOOK_EPOCH_PERSISTED:   // Added by Kleber Kruger
       case HookType::HOOK_EPOCH_TIMEOUT_INS: // Added by Kleber Kruger
+      case HookType::HOOK_CRASH_CHECK:
          Sim()->getHooksManager()->registerHook(type, hookCallbackInt, (UInt64)pFunc);
          break;
       case HookType::HOOK_PRE_STAT_WRITE:
@@ -31,7 +31,8 @@ const char* HookType::hook_type_names[] = {
    "HOOK_EPOCH_END",          // Added by Kleber Kruger
    "HOOK_EPOCH_PERSISTED",    // Added by Kleber Kruger
    "HOOK_EPOCH_TIMEOUT",      // Added by Kleber Kruger
-   "HOOK_EPOCH_TIMEOUT_INS"   // Added by Kleber Kruger
+   "HOOK_EPOCH_TIMEOUT_INS",  // Added by Kleber Kruger
+   "HOOK_CRASH_CHECK"
 };
 static_assert(HookType::HOOK_TYPES_MAX == std::size(HookType::hook_type_names), "Not enough values in HookType::hook_type_names");
 
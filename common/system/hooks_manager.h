@@ -43,6 +43,7 @@ public:
       HOOK_EPOCH_PERSISTED,     // Added by Kleber Kruger            An epoch persisted
       HOOK_EPOCH_TIMEOUT,       // Added by Kleber Kruger            An epoch timeout
       HOOK_EPOCH_TIMEOUT_INS,   // Added by Kleber Kruger            An epoch timeout (by instructions' interval)
+      HOOK_CRASH_CHECK,         // UInt64 mismatched lines           A simulated crash was checked against the last persisted epoch
       HOOK_TYPES_MAX
    };
    static const char* hook_type_names[];
@@ -27,6 +27,7 @@
 #include "instruction_tracer.h"
 #include "memory_tracker.h"
 #include "circular_log.h"
+#include "queue_model_benchmark.h"
 
 #include <ranges>
 
@@ -162,6 +163,7 @@ Simulator::Simulator()
    , m_dvfs_manager(nullptr)
    , m_hooks_manager(nullptr)
    , m_sampling_manager(nullptr)
+   , m_queue_model_benchmark(nullptr)
    , m_faultinjection_manager(nullptr)
    , m_rtn_tracer(nullptr)
    , m_memory_tracker(nullptr)
@@ -187,8 +189,8 @@ void Simulator::start()
    m_thread_stats_manager            = new ThreadStatsManager();
    m_clock_skew_minimization_manager = ClockSkewMinimizationManager::create();
    m_clock_skew_minimization_server  = ClockSkewMinimizationServer::create();
-   m_epoch_manager                   = (m_project_type != ProjectType::BASELINE) ? // Added by Kleber Kruger
-                                           std::optional<EpochManager>(EpochManager()) : std::nullopt;
+   if (m_project_type != ProjectType::BASELINE) // Added by Kleber Kruger
+      m_epoch_manager.emplace();
    m_core_manager                    = new CoreManager();
    m_sim_thread_manager              = new SimThreadManager();
    m_sampling_manager                = new SamplingManager();
@@ -225,6 +227,10 @@ void Simulator::start()
    printInstModeSummary();
    setInstrumentationMode(InstMode::inst_mode_init, true /* update_barrier */);
 
+   m_queue_model_benchmark = QueueModelBenchmark::create();
+   if (m_queue_model_benchmark)
+      m_queue_model_benchmark->run();
+
    /* Save a copy of the configuration for reference */
    m_config_file->saveAs(m_config.formatOutputFileName("sim.cfg"));
 
@@ -289,6 +295,7 @@ Simulator::~Simulator()
    // Don't remove the trace manager as threads could still be alive even if they are done
    //delete m_trace_manager;             m_trace_manager = nullptr;
    delete m_sampling_manager;          m_sampling_manager = nullptr;
+   delete m_queue_model_benchmark;     m_queue_model_benchmark = nullptr;
    if (m_faultinjection_manager)
    {
       delete m_faultinjection_manager; m_faultinjection_manager = nullptr;
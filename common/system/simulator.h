@@ -27,6 +27,7 @@ class FastForwardPerformanceManager;
 class TraceManager;
 class DvfsManager;
 class SamplingManager;
+class QueueModelBenchmark;
 class FaultinjectionManager;
 class TagsManager;
 class RoutineTracer;
@@ -85,7 +86,7 @@ public:
    [[nodiscard]] FaultinjectionManager *getFaultinjectionManager() const { return m_faultinjection_manager; }
    [[nodiscard]] TraceManager *getTraceManager() const { return m_trace_manager; }
    [[nodiscard]] TagsManager *getTagsManager() const { return m_tags_manager; }
-   [[nodiscard]] const std::optional<EpochManager>& getEpochManager() const { return m_epoch_manager; }
+   [[nodiscard]] std::optional<EpochManager>& getEpochManager() { return m_epoch_manager; }
    [[nodiscard]] RoutineTracer *getRoutineTracer() const { return m_rtn_tracer; }
    [[nodiscard]] MemoryTracker *getMemoryTracker() const { return m_memory_tracker; }
    void setMemoryTracker(MemoryTracker *memory_tracker) { m_memory_tracker = memory_tracker; }
@@ -123,6 +124,7 @@ private:
    DvfsManager *m_dvfs_manager;
    HooksManager *m_hooks_manager;
    SamplingManager *m_sampling_manager;
+   QueueModelBenchmark *m_queue_model_benchmark;
    FaultinjectionManager *m_faultinjection_manager;
    std::optional<EpochManager> m_epoch_manager; // Added by Kleber Kruger
    RoutineTracer *m_rtn_tracer;
@@ -0,0 +1,185 @@
+#include "trace_read_ahead.h"
+#include "log.h"
+
+TraceReadAhead::TraceReadAhead(Sift::Reader &trace, UInt32 num_batches, UInt32 batch_size)
+   : m_trace(trace)
+   , m_batch_size(batch_size)
+   , m_ring(num_batches)
+   , m_head(0)
+   , m_tail(0)
+   , m_pos(0)
+   , m_stopped(false)
+   , m_resume(false)
+   , m_exit(false)
+   , m_exited(false)
+   , m_reading(false)
+   , m_detached(false)
+{
+   LOG_ASSERT_ERROR(num_batches > 0 && batch_size > 0, "traceinput/read_ahead_batches and read_ahead_batch_size must be at least 1");
+
+   for(Batch &batch : m_ring)
+      batch.insts.resize(batch_size);
+
+   m_thread = _Thread::create(this);
+   m_thread->run();
+}
+
+TraceReadAhead::~TraceReadAhead()
+{
+   // Unless detached, the helper is either parked at a record (always the case once the trace has ended)
+   // or finishing a batch from a trace file
+   if (!m_detached)
+   {
+      __atomic_store_n(&m_exit, true, __ATOMIC_SEQ_CST);
+      wake(m_producer);
+      waitUntil(m_consumer, [this]() { return __atomic_load_n(&m_exited, __ATOMIC_SEQ_CST); });
+   }
+   delete m_thread;
+}
+
+bool TraceReadAhead::stop()
+{
+   bool detached;
+   {
+      ScopedLock sl(m_lock);
+      __atomic_store_n(&m_exit, true, __ATOMIC_SEQ_CST);
+      // A read from a trace file always returns, a live frontend may not write anything anymore
+      m_detached = m_reading && !m_trace.isFile();
+      detached = m_detached;
+   }
+   if (!detached)
+      wake(m_producer);
+   return !detached;
+}
+
+// Enter the reader, unless asked to exit
+bool TraceReadAhead::startReading()
+{
+   ScopedLock sl(m_lock);
+   if (__atomic_load_n(&m_exit, __ATOMIC_SEQ_CST))
+      return false;
+   m_reading = true;
+   return true;
+}
+
+// Leave the reader, returns whether stop() detached us meanwhile
+bool TraceReadAhead::stopReading()
+{
+   ScopedLock sl(m_lock);
+   m_reading = false;
+   return m_detached;
+}
+
+template <typename F>
+void TraceReadAhead::waitUntil(Waiter &waiter, F ready)
+{
+   if (ready())
+      return;
+
+   // Announce ourselves before checking again: whoever makes ready() true checks waiting after doing so
+   ScopedLock sl(m_lock);
+   __atomic_store_n(&waiter.waiting, 1, __ATOMIC_SEQ_CST);
+   while(!ready())
+      waiter.cond.wait(m_lock);
+   __atomic_store_n(&waiter.waiting, 0, __ATOMIC_SEQ_CST);
+}
+
+void TraceReadAhead::wake(Waiter &waiter)
+{
+   if (__atomic_load_n(&waiter.waiting, __ATOMIC_SEQ_CST))
+   {
+      ScopedLock sl(m_lock);
+      waiter.cond.signal();
+   }
+}
+
+void TraceReadAhead::run()
+{
+   UInt64 head = 0;
+   while(true)
+   {
+      // Wait for a free batch
+      waitUntil(m_producer, [this, head]() { return __atomic_load_n(&m_exit, __ATOMIC_SEQ_CST) || head - __atomic_load_n(&m_tail, __ATOMIC_SEQ_CST) < m_ring.size(); });
+      if (__atomic_load_n(&m_exit, __ATOMIC_SEQ_CST))
+         break;
+
+      Batch &batch = m_ring[head % m_ring.size()];
+      if (!startReading())
+         break;
+      batch.count = m_trace.ReadAhead(batch.insts.data(), m_batch_size);
+      if (stopReading())
+      {
+         // Nobody waits for us anymore
+         delete this;
+         return;
+      }
+      batch.stop = batch.count < m_batch_size;
+
+      __atomic_store_n(&m_head, ++head, __ATOMIC_SEQ_CST);
+      wake(m_consumer);
+
+      if (batch.stop)
+      {
+         // Stay off the reader until the consumer has handled the record we stopped at
+         waitUntil(m_producer, [this]() { return __atomic_load_n(&m_resume, __ATOMIC_SEQ_CST) || __atomic_load_n(&m_exit, __ATOMIC_SEQ_CST); });
+         __atomic_store_n(&m_resume, false, __ATOMIC_SEQ_CST);
+      }
+   }
+
+   __atomic_store_n(&m_exited, true, __ATOMIC_SEQ_CST);
+   wake(m_consumer);
+}
+
+// Hand the used-up batch at m_tail back to the helper, returns whether the helper stopped after it
+bool TraceReadAhead::retireBatch()
+{
+   bool stop = m_ring[m_tail % m_ring.size()].stop;
+   m_pos = 0;
+   __atomic_store_n(&m_tail, m_tail + 1, __ATOMIC_SEQ_CST);
+   wake(m_producer);
+   return stop;
+}
+
+bool TraceReadAhead::Read(Sift::Instruction &inst)
+{
+   while(!m_stopped)
+   {
+      waitUntil(m_consumer, [this]() { return __atomic_load_n(&m_head, __ATOMIC_SEQ_CST) != m_tail; });
+
+      Batch &batch = m_ring[m_tail % m_ring.size()];
+      if (m_pos < batch.count)
+      {
+         inst = batch.insts[m_pos++];
+         return true;
+      }
+
+      m_stopped = retireBatch();
+   }
+
+   // The helper is parked: handle the record it stopped at (or the end of the trace) on this thread
+   m_stopped = false;
+   bool have_inst = m_trace.Read(inst);
+   if (have_inst)
+   {
+      __atomic_store_n(&m_resume, true, __ATOMIC_SEQ_CST);
+      wake(m_producer);
+   }
+   return have_inst;
+}
+
+size_t TraceReadAhead::ReadAhead(Sift::Instruction *insts, size_t count)
+{
+   size_t n = 0;
+   while(n < count && !m_stopped)
+   {
+      waitUntil(m_consumer, [this]() { return __atomic_load_n(&m_head, __ATOMIC_SEQ_CST) != m_tail; });
+
+      Batch &batch = m_ring[m_tail % m_ring.size()];
+      while(m_pos < batch.count && n < count)
+         insts[n++] = batch.insts[m_pos++];
+
+      if (m_pos == batch.count)
+         m_stopped = retireBatch();
+   }
+   return n;
+}
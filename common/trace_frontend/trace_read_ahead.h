@@ -0,0 +1,76 @@
+#ifndef __TRACE_READ_AHEAD_H
+#define __TRACE_READ_AHEAD_H
+
+#include "fixed_types.h"
+#include "_thread.h"
+#include "lock.h"
+#include "cond.h"
+#include "sift_reader.h"
+
+#include <vector>
+
+// Decodes a SIFT trace on a helper thread, ahead of the thread that simulates it.
+//
+// The helper fills a single-producer/single-consumer ring of instruction batches using Sift::Reader::ReadAhead.
+// It only decodes instructions and the code and ISA records they need. Every other record stops it: those that
+// need a callback or a response (syscalls, thread events, magic instructions, ...), and also the logical to
+// physical address mappings, since Sift::Reader::va2pa reads them on the simulation thread. The consumer drains
+// the ring and handles the record itself with Sift::Reader::Read, so callbacks run on the simulation thread in
+// trace order, and only then lets the helper continue. The reader is never used by both threads at the same time.
+// The ring indices are only written by one side each, so the common case takes no lock; the lock and condition
+// variables are only used to sleep on an empty or full ring, or while the helper is stopped.
+class TraceReadAhead : public Runnable
+{
+   public:
+      TraceReadAhead(Sift::Reader &trace, UInt32 num_batches, UInt32 batch_size);
+      ~TraceReadAhead();
+
+      // Ask the helper to exit. Returns false if it is blocked reading a live trace (a pipe), which may never return:
+      // the helper is then detached and deletes this object itself once its read returns, so do not delete it.
+      bool stop();
+
+      // Same contract as Sift::Reader::Read and ReadAhead, only call from the simulation thread
+      bool Read(Sift::Instruction &inst);
+      size_t ReadAhead(Sift::Instruction *insts, size_t count);
+
+   private:
+      struct Batch
+      {
+         std::vector<Sift::Instruction> insts;
+         UInt32 count;
+         bool stop;  // The helper stopped after this batch: the next record is for the consumer
+      };
+
+      Sift::Reader &m_trace;
+      const UInt32 m_batch_size;
+      std::vector<Batch> m_ring;
+      UInt64 m_head;  // Batches produced, written by the helper
+      UInt64 m_tail;  // Batches consumed, written by the consumer
+      UInt32 m_pos;   // Next instruction in the batch at m_tail
+      bool m_stopped; // ReadAhead consumed the batch the helper stopped after, the next Read handles the record
+      bool m_resume;  // Consumer handled the record the helper stopped at
+      bool m_exit;
+      bool m_exited;
+      bool m_reading;  // The helper is inside the reader, written under m_lock
+      bool m_detached; // stop() left the helper behind, written under m_lock
+      // One condition variable per side, so each only ever has a single waiter
+      struct Waiter
+      {
+         UInt32 waiting;
+         ConditionVariable cond;
+         Waiter() : waiting(0) {}
+      };
+      Lock m_lock;
+      Waiter m_producer;
+      Waiter m_consumer;
+      _Thread *m_thread;
+
+      void run();
+      template <typename F> void waitUntil(Waiter &waiter, F ready);
+      void wake(Waiter &waiter);
+      bool retireBatch();
+      bool startReading();
+      bool stopReading();
+};
+
+#endif // __TRACE_READ_AHEAD_H
@@ -1,5 +1,6 @@
 #include "trace_thread.h"
 #include "trace_manager.h"
+#include "trace_read_ahead.h"
 #include "simulator.h"
 #include "core_manager.h"
 #include "thread_manager.h"
@@ -9,6 +10,7 @@
 #include "dynamic_instruction.h"
 #include "performance_model.h"
 #include "instruction_decoder_wlib.h"
+#include "micro_op.h"
 #include "config.hpp"
 #include "syscall_model.h"
 #include "core.h"
@@ -20,6 +22,7 @@
 
 #include "stats.h"
 
+#include <algorithm>
 #include <unistd.h>
 #include <sys/syscall.h>
 
@@ -31,11 +34,16 @@ TraceThread::TraceThread(Thread *thread, SubsecondTime time_start, String tracef
    : m__thread(NULL)
    , m_thread(thread)
    , m_time_start(time_start)
-   , m_trace(tracefile.c_str(), responsefile.c_str(), thread->getId())
+   , m_trace(new Sift::Reader(tracefile.c_str(), responsefile.c_str(), thread->getId()))
+   , m_read_ahead(NULL)
+   , m_trace_detached(false)
    , m_trace_has_pa(false)
    , m_address_randomization(Sim()->getCfg()->getBool("traceinput/address_randomization"))
    , m_appid_from_coreid(Sim()->getCfg()->getString("scheduler/type") == "sequential" ? true : false)
    , m_stop(false)
+   , m_static_insts_hits(0)
+   , m_static_insts_misses(0)
+   , m_static_insts_bytes(0)
    , m_bbv_base(0)
    , m_bbv_count(0)
    , m_bbv_last(0)
@@ -47,21 +55,32 @@ TraceThread::TraceThread(Thread *thread, SubsecondTime time_start, String tracef
    , m_blocked(false)
    , m_cleanup(cleanup)
    , m_started(false)
+   , m_fast_warmup(Sim()->getCfg()->getBoolDefault("perf_model/cache/fast_warmup", false))
+   , m_warmup_core(NULL)
+   , m_skip_batch(Sim()->getCfg()->getInt("traceinput/fast_forward_batch"))
+   , m_skip_pos(0)
+   , m_skip_count(0)
+   , m_skip_seek(Sim()->getCfg()->getBoolDefault("traceinput/fast_forward_seek", false))
    , m_stopped(false)
 {
+   m_warmup_batch.reserve(WARMUP_BATCH_SIZE);
 
-   m_trace.setHandleInstructionCountFunc(TraceThread::__handleInstructionCountFunc, this);
-   m_trace.setHandleCacheOnlyFunc(TraceThread::__handleCacheOnlyFunc, this);
+   registerStatsMetric("trace", thread->getId(), "static_insts_hits", &m_static_insts_hits);
+   registerStatsMetric("trace", thread->getId(), "static_insts_misses", &m_static_insts_misses);
+   registerStatsMetric("trace", thread->getId(), "static_insts_bytes", &m_static_insts_bytes);
+
+   m_trace->setHandleInstructionCountFunc(TraceThread::__handleInstructionCountFunc, this);
+   m_trace->setHandleCacheOnlyFunc(TraceThread::__handleCacheOnlyFunc, this);
    if (Sim()->getCfg()->getBool("traceinput/mirror_output"))
-      m_trace.setHandleOutputFunc(TraceThread::__handleOutputFunc, this);
-   m_trace.setHandleSyscallFunc(TraceThread::__handleSyscallFunc, this);
-   m_trace.setHandleNewThreadFunc(TraceThread::__handleNewThreadFunc, this);
-   m_trace.setHandleJoinFunc(TraceThread::__handleJoinFunc, this);
-   m_trace.setHandleMagicFunc(TraceThread::__handleMagicFunc, this);
-   m_trace.setHandleEmuFunc(TraceThread::__handleEmuFunc, this);
-   m_trace.setHandleForkFunc(TraceThread::__handleForkFunc, this);
+      m_trace->setHandleOutputFunc(TraceThread::__handleOutputFunc, this);
+   m_trace->setHandleSyscallFunc(TraceThread::__handleSyscallFunc, this);
+   m_trace->setHandleNewThreadFunc(TraceThread::__handleNewThreadFunc, this);
+   m_trace->setHandleJoinFunc(TraceThread::__handleJoinFunc, this);
+   m_trace->setHandleMagicFunc(TraceThread::__handleMagicFunc, this);
+   m_trace->setHandleEmuFunc(TraceThread::__handleEmuFunc, this);
+   m_trace->setHandleForkFunc(TraceThread::__handleForkFunc, this);
    if (Sim()->getRoutineTracer())
-      m_trace.setHandleRoutineFunc(TraceThread::__handleRoutineChangeFunc, TraceThread::__handleRoutineAnnounceFunc, this);
+      m_trace->setHandleRoutineFunc(TraceThread::__handleRoutineChangeFunc, TraceThread::__handleRoutineAnnounceFunc, this);
 
    if (m_address_randomization)
    {
@@ -85,14 +104,21 @@ TraceThread::TraceThread(Thread *thread, SubsecondTime time_start, String tracef
 TraceThread::~TraceThread()
 {
    delete m__thread;
+   // A detached read-ahead helper is still blocked reading the trace, leave the reader to it
+   if (!m_trace_detached)
+      delete m_trace;
    if (m_cleanup)
    {
       unlink(m_tracefile.c_str());
       unlink(m_responsefile.c_str());
    }
-   for(std::unordered_map<IntPtr, const dl::DecodedInst *>::iterator i = m_decoder_cache.begin() ; i != m_decoder_cache.end() ; ++i)
+   // Instructions can still be referenced from the performance model and are not deleted: produce their
+   // disassembly now, as it is done lazily from the decoded instruction
+   for(std::unordered_map<IntPtr, StaticInstruction>::iterator i = m_static_insts.begin() ; i != m_static_insts.end() ; ++i)
    {
-      delete (*i).second;
+      if ((*i).second.instruction)
+         (*i).second.instruction->getDisassembly();
+      delete (*i).second.decoded;
    }
 }
 
@@ -100,7 +126,7 @@ UInt64 TraceThread::va2pa(UInt64 va, bool *noMapping)
 {
    if (m_trace_has_pa)
    {
-      UInt64 pa = m_trace.va2pa(va);
+      UInt64 pa = m_trace->va2pa(va);
       if (pa != 0)
       {
          return pa;
@@ -375,15 +401,32 @@ SubsecondTime TraceThread::getCurrentTime() const
    return m_thread->getCore()->getPerformanceModel()->getElapsedTime();
 }
 
-Instruction* TraceThread::decode(Sift::Instruction &inst)
+static String disassemble(const void *dec_inst)
 {
+   return ((const dl::DecodedInst *)dec_inst)->disassembly_to_str().c_str();
+}
 
-   //printf("PC: %lx Size: %d num_addresses=%d is_branch=%d\n", inst.sinst->addr, inst.sinst->size, inst.num_addresses, inst.is_branch);
-   if (m_decoder_cache.count(inst.sinst->addr) == 0)
-      m_decoder_cache[inst.sinst->addr] = staticDecode(inst);
-   
-   const dl::DecodedInst& dec_inst = *(m_decoder_cache[inst.sinst->addr]);
+TraceThread::StaticInstruction& TraceThread::getStaticInstruction(Sift::Instruction &inst)
+{
+   std::pair<std::unordered_map<IntPtr, StaticInstruction>::iterator, bool> res = m_static_insts.insert(std::make_pair(inst.sinst->addr, StaticInstruction()));
+   StaticInstruction &sinst = res.first->second;
+
+   if (res.second)
+   {
+      //printf("PC: %lx Size: %d num_addresses=%d is_branch=%d\n", inst.sinst->addr, inst.sinst->size, inst.num_addresses, inst.is_branch);
+      sinst.decoded = staticDecode(inst);
+      sinst.instruction = NULL;
+      ++m_static_insts_misses;
+      m_static_insts_bytes += sizeof(*res.first) + 2 * sizeof(void*);
+   }
+   else
+      ++m_static_insts_hits;
+
+   return sinst;
+}
 
+Instruction* TraceThread::decode(Sift::Instruction &inst, const dl::DecodedInst &dec_inst)
+{
    OperandList list;
 
    // Ignore memory-referencing operands in NOP instructions
@@ -408,11 +451,14 @@ Instruction* TraceThread::decode(Sift::Instruction &inst)
    instruction->setAddress(va2pa(inst.sinst->addr));
    instruction->setSize(inst.sinst->size);
    instruction->setAtomic(dec_inst.is_atomic());
-   instruction->setDisassembly(dec_inst.disassembly_to_str().c_str());
-   
+   instruction->setDisassembly(disassemble, &dec_inst);
+
    const std::vector<const MicroOp*> *uops = InstructionDecoder::decode(inst.sinst->addr, &dec_inst, instruction);
    instruction->setMicroOps(uops);
 
+   m_static_insts_bytes += sizeof(*instruction) + list.size() * sizeof(Operand)
+                         + sizeof(*uops) + uops->size() * (sizeof(const MicroOp*) + sizeof(MicroOp));
+
    return instruction;
 }
 
@@ -492,6 +538,11 @@ void TraceThread::handleCacheOnlyFunc(uint8_t icount, Sift::CacheOnlyType type,
 
       case Sift::CacheOnlyMemRead:
       case Sift::CacheOnlyMemWrite:
+         if (m_fast_warmup)
+         {
+            warmMemory(core, false, type == Sift::CacheOnlyMemRead ? Core::READ : Core::WRITE, va2pa(address), 4, va2pa(eip));
+            break;
+         }
          core->accessMemory(
                Core::NONE,
                type == Sift::CacheOnlyMemRead ? Core::READ : Core::WRITE,
@@ -504,9 +555,17 @@ void TraceThread::handleCacheOnlyFunc(uint8_t icount, Sift::CacheOnlyType type,
 
       case Sift::CacheOnlyMemIcache:
          if (Sim()->getConfig()->getEnableICacheModeling())
-            core->readInstructionMemory(va2pa(eip), address);
+         {
+            if (m_fast_warmup)
+               warmMemory(core, true, Core::READ, va2pa(eip), address, va2pa(eip));
+            else
+               core->readInstructionMemory(va2pa(eip), address);
+         }
          break;
    }
+
+   // The record may be followed by a syscall or a reschedule, do not leave its accesses queued
+   flushWarmup();
 }
 
 const dl::DecodedInst* TraceThread::staticDecode(Sift::Instruction &inst)
@@ -519,16 +578,16 @@ const dl::DecodedInst* TraceThread::staticDecode(Sift::Instruction &inst)
 
 void TraceThread::handleInstructionWarmup(Sift::Instruction &inst, Sift::Instruction &next_inst, Core *core, bool do_icache_warmup, UInt64 icache_warmup_addr, UInt64 icache_warmup_size)
 {
-   if (m_decoder_cache.count(inst.sinst->addr) == 0)
-      m_decoder_cache[inst.sinst->addr] = staticDecode(inst);
-   
-   const dl::DecodedInst &dec_inst = *(m_decoder_cache[inst.sinst->addr]);
+   const dl::DecodedInst &dec_inst = *getStaticInstruction(inst).decoded;
 
    // Warmup instruction caches
 
    if (do_icache_warmup && Sim()->getConfig()->getEnableICacheModeling())
    {
-      core->readInstructionMemory(va2pa(icache_warmup_addr), icache_warmup_size);
+      if (m_fast_warmup)
+         warmMemory(core, true, Core::READ, va2pa(icache_warmup_addr), icache_warmup_size, va2pa(icache_warmup_addr));
+      else
+         core->readInstructionMemory(va2pa(icache_warmup_addr), icache_warmup_size);
    }
 
    // Warmup branch predictor
@@ -574,14 +633,17 @@ void TraceThread::handleInstructionWarmup(Sift::Instruction &inst, Sift::Instruc
                if (no_mapping)
                   continue;
 
-               core->accessMemory(
-                     /*(is_atomic_update) ? Core::LOCK :*/ Core::NONE,
-                     (is_atomic_update) ? Core::READ_EX : Core::READ,
-                     pa,
-                     NULL,
-                     Sim()->getDecoder()->size_mem_op(&dec_inst, mem_idx),
-                     Core::MEM_MODELED_COUNT,
-                     va2pa(inst.sinst->addr));
+               if (m_fast_warmup)
+                  warmMemory(core, false, (is_atomic_update) ? Core::READ_EX : Core::READ, pa, Sim()->getDecoder()->size_mem_op(&dec_inst, mem_idx), va2pa(inst.sinst->addr));
+               else
+                  core->accessMemory(
+                        /*(is_atomic_update) ? Core::LOCK :*/ Core::NONE,
+                        (is_atomic_update) ? Core::READ_EX : Core::READ,
+                        pa,
+                        NULL,
+                        Sim()->getDecoder()->size_mem_op(&dec_inst, mem_idx),
+                        Core::MEM_MODELED_COUNT,
+                        va2pa(inst.sinst->addr));
             }
          }
 
@@ -611,6 +673,8 @@ void TraceThread::handleInstructionWarmup(Sift::Instruction &inst, Sift::Instruc
 
                if (is_atomic_update)
                   core->logMemoryHit(false, Core::WRITE, pa, Core::MEM_MODELED_COUNT, va2pa(inst.sinst->addr));
+               else if (m_fast_warmup)
+                  warmMemory(core, false, Core::WRITE, pa, Sim()->getDecoder()->size_mem_op(&dec_inst, mem_idx), va2pa(inst.sinst->addr));
                else
                   core->accessMemory(
                         /*(is_atomic_update) ? Core::UNLOCK :*/ Core::NONE,
@@ -624,6 +688,27 @@ void TraceThread::handleInstructionWarmup(Sift::Instruction &inst, Sift::Instruc
          }
       }
    }
+
+   // Accesses are only batched within an instruction, they must reach the core the thread runs on now
+   flushWarmup();
+}
+
+void TraceThread::warmMemory(Core *core, bool icache, Core::mem_op_t mem_op_type, IntPtr address, UInt32 size, IntPtr eip)
+{
+   if (m_warmup_batch.size() == WARMUP_BATCH_SIZE)
+      flushWarmup();
+
+   m_warmup_core = core;
+   m_warmup_batch.push_back({ icache, mem_op_type, address, size, eip });
+}
+
+void TraceThread::flushWarmup()
+{
+   if (!m_warmup_batch.empty())
+   {
+      m_warmup_core->warmMemory(m_warmup_batch.data(), m_warmup_batch.size());
+      m_warmup_batch.clear();
+   }
 }
 
 void TraceThread::handleInstructionDetailed(Sift::Instruction &inst, Sift::Instruction &next_inst, PerformanceModel *prfmdl)
@@ -631,12 +716,12 @@ void TraceThread::handleInstructionDetailed(Sift::Instruction &inst, Sift::Instr
 
    // Set up instruction
 
-   if (m_icache.count(inst.sinst->addr) == 0)
-      m_icache[inst.sinst->addr] = decode(inst);
-   // Here get the decoder instruction without checking, because we must have it for sure
-   const dl::DecodedInst &dec_inst = *(m_decoder_cache[inst.sinst->addr]);
+   StaticInstruction &sinst = getStaticInstruction(inst);
+   const dl::DecodedInst &dec_inst = *sinst.decoded;
+   if (!sinst.instruction)
+      sinst.instruction = decode(inst, dec_inst);
 
-   Instruction *ins = m_icache[inst.sinst->addr];
+   Instruction *ins = sinst.instruction;
    DynamicInstruction *dynins = prfmdl->createDynamicInstruction(ins, va2pa(inst.sinst->addr));
 
    // Add dynamic instruction info
@@ -756,8 +841,8 @@ void TraceThread::run()
    Sim()->getThreadManager()->onThreadStart(m_thread->getId(), m_time_start);
 
    // Open the trace (be sure to do this before potentially blocking on reschedule() as this causes deadlock)
-   m_trace.initStream();
-   m_trace_has_pa = m_trace.getTraceHasPhysicalAddresses();
+   m_trace->initStream();
+   m_trace_has_pa = m_trace->getTraceHasPhysicalAddresses();
 
    if (m_thread->getCore() == NULL)
    {
@@ -769,11 +854,19 @@ void TraceThread::run()
    Core *core = m_thread->getCore();
    PerformanceModel *prfmdl = core->getPerformanceModel();
 
+   if (Sim()->getCfg()->getBoolDefault("traceinput/read_ahead", false))
+      m_read_ahead = new TraceReadAhead(*m_trace, Sim()->getCfg()->getInt("traceinput/read_ahead_batches"), Sim()->getCfg()->getInt("traceinput/read_ahead_batch_size"));
+
+   // The helper thread owns the reader, so we cannot seek it
+   if (m_read_ahead)
+      m_skip_seek = false;
+
    Sift::Instruction inst, next_inst;
+   bool counted = false;  // inst was already counted by fastForward
 
-   bool have_first = m_trace.Read(inst);
+   bool have_first = readInstruction(inst);
 
-   while(have_first && m_trace.Read(next_inst))
+   while(have_first && readInstruction(next_inst))
    {
       if (!m_started)
       {
@@ -795,30 +888,39 @@ void TraceThread::run()
 
       // Reconstruct and count basic blocks
 
-      if (m_bbv_end || m_bbv_last != inst.sinst->addr)
+      if (counted)
+      {
+         counted = false;
+      }
+      else
       {
-         // We're the start of a new basic block
-         core->countInstructions(m_bbv_base, m_bbv_count);
-         // In cache-only mode, we'll want to do I-cache warmup
-         if (m_bbv_base)
+         if (m_bbv_end || m_bbv_last != inst.sinst->addr)
          {
-            do_icache_warmup = true;
-            icache_warmup_addr = m_bbv_base;
-            icache_warmup_size = m_bbv_last - m_bbv_base;
+            // We're the start of a new basic block
+            core->countInstructions(m_bbv_base, m_bbv_count);
+            // In cache-only mode, we'll want to do I-cache warmup
+            if (m_bbv_base)
+            {
+               do_icache_warmup = true;
+               icache_warmup_addr = m_bbv_base;
+               icache_warmup_size = m_bbv_last - m_bbv_base;
+            }
+            // Set up new basic block info
+            m_bbv_base = inst.sinst->addr;
+            m_bbv_count = 0;
          }
-         // Set up new basic block info
-         m_bbv_base = inst.sinst->addr;
-         m_bbv_count = 0;
+         m_bbv_count++;
+         m_bbv_last = inst.sinst->addr + inst.sinst->size;
+         // Force BBV end on non-taken branches
+         m_bbv_end = inst.is_branch;
       }
-      m_bbv_count++;
-      m_bbv_last = inst.sinst->addr + inst.sinst->size;
-      // Force BBV end on non-taken branches
-      m_bbv_end = inst.is_branch;
 
 
       switch(Sim()->getInstrumentationMode())
       {
          case InstMode::FAST_FORWARD:
+            if (!m_skip_batch.empty())
+               counted = fastForward(next_inst, core);
             break;
 
          case InstMode::CACHE_ONLY:
@@ -838,6 +940,7 @@ void TraceThread::run()
       // by prfmdl->iterate (in handleInstructionDetailed),
       // or core->countInstructions (when using a fast-forward performance model)
       SubsecondTime time = prfmdl->getElapsedTime();
+      flushWarmup();
       if (m_thread->reschedule(time, core))
       {
          core = m_thread->getCore();
@@ -851,6 +954,17 @@ void TraceThread::run()
       inst = next_inst;
    }
 
+   flushWarmup();
+
+   if (m_read_ahead)
+   {
+      if (m_read_ahead->stop())
+         delete m_read_ahead;
+      else
+         m_trace_detached = true;
+      m_read_ahead = NULL;
+   }
+
    printf("[TRACE:%u] -- %s --\n", m_thread->getId(), m_stop ? "STOP" : "DONE");
 
    SubsecondTime time_end = prfmdl->getElapsedTime();
@@ -859,6 +973,123 @@ void TraceThread::run()
    Sim()->getTraceManager()->signalDone(this, time_end, m_stop /*aborted*/);
 }
 
+bool TraceThread::readInstruction(Sift::Instruction &inst)
+{
+   if (m_skip_pos < m_skip_count)
+   {
+      inst = m_skip_batch[m_skip_pos++];
+      return true;
+   }
+   return m_read_ahead ? m_read_ahead->Read(inst) : m_trace->Read(inst);
+}
+
+// Fast-forward over next_inst and the instructions after it: decode them in batches, and only reconstruct and count
+// their basic blocks. Stops at the first record that needs handling (syscalls, thread events, magic instructions, ...),
+// left for readInstruction, or once counting a basic block changed the instrumentation mode or may have rescheduled
+// the thread. Returns with next_inst the last instruction counted.
+bool TraceThread::fastForward(Sift::Instruction &next_inst, Core *core)
+{
+   while(true)
+   {
+      bool leave = false;
+      if (m_bbv_end || m_bbv_last != next_inst.sinst->addr)
+      {
+         leave = core->countInstructions(m_bbv_base, m_bbv_count)
+              || Sim()->getInstrumentationMode() != InstMode::FAST_FORWARD
+              || m_thread->getCore() != core;
+         m_bbv_base = next_inst.sinst->addr;
+         m_bbv_count = 0;
+      }
+      m_bbv_count++;
+      m_bbv_last = next_inst.sinst->addr + next_inst.sinst->size;
+      m_bbv_end = next_inst.is_branch;
+
+      if (leave || m_stop)
+         return true;
+
+      if (m_skip_pos == m_skip_count)
+      {
+         size_t count = m_skip_batch.size();
+         if (m_skip_seek)
+         {
+            count = std::min<UInt64>(count, seekFastForward(core, leave));
+            if (leave)
+               return true;
+         }
+         m_skip_count = m_read_ahead ? m_read_ahead->ReadAhead(m_skip_batch.data(), count) : m_trace->ReadAhead(m_skip_batch.data(), count);
+         m_skip_pos = 0;
+         if (m_skip_count == 0)
+            return true;
+      }
+      next_inst = m_skip_batch[m_skip_pos++];
+   }
+}
+
+// With a block-indexed trace, jump over whole blocks without events instead of decoding them. Their instructions are
+// counted at once, as a basic block at address zero. Returns how many instructions to decode before the next block,
+// and sets leave if counting changed the instrumentation mode or may have rescheduled the thread (as in fastForward).
+UInt64 TraceThread::seekFastForward(Core *core, bool &leave)
+{
+   const std::vector<Sift::BlockIndexEntry> *index = m_trace->getBlockIndex();
+   if (!index)
+      return UINT64_MAX;
+
+   UInt64 icount = m_trace->getInstructionCount();
+   std::vector<Sift::BlockIndexEntry>::const_iterator next = std::upper_bound(index->begin(), index->end(), icount,
+      [](UInt64 icount, const Sift::BlockIndexEntry &entry) { return icount < entry.icount; });
+
+   // Only from the start of a block: the part of the current one still to read may have events
+   if (next != index->begin() && (next - 1)->icount == icount)
+   {
+      // Leave the core's next instruction callback, and the last block, to the regular path
+      UInt64 limit = UINT64_MAX;
+      if (core->isEnabledInstructionsCallback())
+      {
+         UInt64 counted = core->getInstructionCount() + m_bbv_count;
+         limit = core->getInstructionsCallback() > counted ? icount + core->getInstructionsCallback() - counted : icount;
+      }
+
+      std::vector<Sift::BlockIndexEntry>::const_iterator target = next - 1;
+      while(target + 1 != index->end() && !(target->flags & Sift::BlockHasEvents) && (target + 1)->icount < limit)
+         ++target;
+
+      if (target->icount > icount)
+      {
+         // Count the pending basic block first: if that already stops the fast-forward, do not skip anything
+         leave = core->countInstructions(m_bbv_base, m_bbv_count)
+              || Sim()->getInstrumentationMode() != InstMode::FAST_FORWARD
+              || m_thread->getCore() != core;
+         // The next instruction starts a new basic block
+         m_bbv_base = 0;
+         m_bbv_count = 0;
+         m_bbv_end = true;
+
+         if (leave)
+            return 0;
+
+         if (m_trace->Seek(target->icount))
+         {
+            // The blocks are gone, so all of their instructions are counted even if one count stops the fast-forward
+            for(UInt64 skipped = target->icount - icount; skipped > 0; )
+            {
+               UInt32 count = std::min<UInt64>(skipped, UINT32_MAX);
+               if (core->countInstructions(0, count))
+                  leave = true;
+               skipped -= count;
+            }
+            leave = leave
+                 || Sim()->getInstrumentationMode() != InstMode::FAST_FORWARD
+                 || m_thread->getCore() != core;
+
+            icount = target->icount;
+            next = target + 1;
+         }
+      }
+   }
+
+   return next == index->end() ? UINT64_MAX : next->icount - icount;
+}
+
 void TraceThread::spawn()
 {
    m__thread = _Thread::create(this);
@@ -867,12 +1098,12 @@ void TraceThread::spawn()
 
 UInt64 TraceThread::getProgressExpect()
 {
-   return m_trace.getLength();
+   return m_trace->getLength();
 }
 
 UInt64 TraceThread::getProgressValue()
 {
-   return m_trace.getPosition();
+   return m_trace->getPosition();
 }
 
 void TraceThread::handleAccessMemory(Core::lock_signal_t lock_signal, Core::mem_op_t mem_op_type, IntPtr d_addr, char* data_buffer, UInt32 data_size)
@@ -910,5 +1141,5 @@ void TraceThread::handleAccessMemory(Core::lock_signal_t lock_signal, Core::mem_
          break;
    }
 
-   m_trace.AccessMemory(sift_lock_signal, sift_mem_op, d_addr, (uint8_t*)data_buffer, data_size);
+   m_trace->AccessMemory(sift_lock_signal, sift_mem_op, d_addr, (uint8_t*)data_buffer, data_size);
 }
@@ -12,6 +12,7 @@
 #include <decoder.h>
 
 #include <unordered_map>
+#include <vector>
 
 #define NUM_PAPI_COUNTERS 6
 
@@ -24,6 +25,7 @@
 
 class Instruction;
 class DynamicInstruction;
+class TraceReadAhead;
 
 class TraceThread : public Runnable
 {
@@ -49,14 +51,24 @@ class TraceThread : public Runnable
       _Thread *m__thread;
       Thread *m_thread;
       SubsecondTime m_time_start;
-      Sift::Reader m_trace;
+      Sift::Reader *m_trace;
+      TraceReadAhead *m_read_ahead;  // Decodes m_trace on a helper thread (traceinput/read_ahead)
+      bool m_trace_detached;         // m_read_ahead was left blocked reading m_trace at the end of the trace
       bool m_trace_has_pa;
       bool m_address_randomization;
       bool m_appid_from_coreid;
       uint8_t m_address_randomization_table[256];
       bool m_stop;
-      std::unordered_map<IntPtr, Instruction *> m_icache;
-      std::unordered_map<IntPtr, const dl::DecodedInst *> m_decoder_cache;
+      // Static information per instruction address, shared by all of its dynamic executions
+      struct StaticInstruction
+      {
+         const dl::DecodedInst *decoded;
+         Instruction *instruction;  // Operands and micro-ops, built on first use in detailed mode
+      };
+      std::unordered_map<IntPtr, StaticInstruction> m_static_insts;
+      UInt64 m_static_insts_hits;
+      UInt64 m_static_insts_misses;
+      UInt64 m_static_insts_bytes;  // Approximate, not counting decoder-internal data
       UInt64 m_bbv_base;
       UInt64 m_bbv_count;
       UInt64 m_bbv_last;
@@ -70,8 +82,21 @@ class TraceThread : public Runnable
       bool m_blocked;
       bool m_cleanup;
       bool m_started;
+      // Functional warming (CACHE_ONLY) accesses of the current instruction or cache-only record, handed to the core at once
+      static const UInt32 WARMUP_BATCH_SIZE = 64;
+      bool m_fast_warmup;
+      std::vector<Core::WarmupAccess> m_warmup_batch;
+      Core *m_warmup_core;
+      // Fast-forward mode: instructions decoded in bulk and not yet returned by readInstruction
+      std::vector<Sift::Instruction> m_skip_batch;
+      size_t m_skip_pos;
+      size_t m_skip_count;
+      bool m_skip_seek;
 
       void run();
+      bool readInstruction(Sift::Instruction &inst);
+      bool fastForward(Sift::Instruction &next_inst, Core *core);
+      UInt64 seekFastForward(Core *core, bool &leave);
       static Sift::Mode __handleInstructionCountFunc(void* arg, uint32_t icount)
       { return ((TraceThread*)arg)->handleInstructionCountFunc(icount); }
       static void __handleCacheOnlyFunc(void* arg, uint8_t icount, Sift::CacheOnlyType type, uint64_t eip, uint64_t address)
@@ -107,9 +132,12 @@ class TraceThread : public Runnable
       void handleRoutineChangeFunc(Sift::RoutineOpType event, uint64_t eip, uint64_t esp, uint64_t callEip);
       void handleRoutineAnnounceFunc(uint64_t eip, const char *name, const char *imgname, uint64_t offset, uint32_t line, uint32_t column, const char *filename);
 
-      Instruction* decode(Sift::Instruction &inst);
+      StaticInstruction& getStaticInstruction(Sift::Instruction &inst);
+      Instruction* decode(Sift::Instruction &inst, const dl::DecodedInst &dec_inst);
       void handleInstructionWarmup(Sift::Instruction &inst, Sift::Instruction &next_inst, Core *core, bool do_icache_warmup, UInt64 icache_warmup_addr, UInt64 icache_warmup_size);
       void handleInstructionDetailed(Sift::Instruction &inst, Sift::Instruction &next_inst, PerformanceModel *prfmdl);
+      void warmMemory(Core *core, bool icache, Core::mem_op_t mem_op_type, IntPtr address, UInt32 size, IntPtr eip);
+      void flushWarmup();
       void addDetailedMemoryInfo(DynamicInstruction *dynins, Sift::Instruction &inst, const dl::DecodedInst &decoded_inst, uint32_t mem_idx, Operand::Direction op_type, bool is_pretetch, PerformanceModel *prfmdl);
       void unblock();
 
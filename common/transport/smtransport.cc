@@ -91,13 +91,26 @@ void SmTransport::SmNode::send(SInt32 dest_id, const void* buffer, UInt32 length
    send(dest_node, buffer, length);
 }
 
+void SmTransport::SmNode::sendOwned(SInt32 dest_id, Byte* buffer, UInt32 length)
+{
+   SmNode *dest_node = m_smt->getNodeFromId(dest_id);
+   LOG_ASSERT_ERROR(dest_node != NULL, "Attempt to send to non-existent node: %d", dest_id);
+
+   LOG_PRINT("sending msg -- size: %i, data: %p, dest: %p", length, buffer, dest_node);
+   enqueue(dest_node, buffer);
+}
+
 void SmTransport::SmNode::send(SmNode *dest_node, const void *buffer, UInt32 length)
 {
    Byte *data = new Byte[length];
    memcpy(data, buffer, length);
 
    LOG_PRINT("sending msg -- size: %i, data: %p, dest: %p", length, data, dest_node);
+   enqueue(dest_node, data);
+}
 
+void SmTransport::SmNode::enqueue(SmNode *dest_node, Byte *data)
+{
    dest_node->m_lock.acquire();
    dest_node->m_queue.push(data);
    dest_node->m_lock.release();
@@ -20,11 +20,13 @@ public:
 
       void globalSend(SInt32, const void*, UInt32);
       void send(core_id_t, const void*, UInt32);
+      void sendOwned(core_id_t, Byte*, UInt32);
       Byte* recv();
       bool query();
 
    private:
       void send(SmNode *dest, const void *buffer, UInt32 length);
+      void enqueue(SmNode *dest, Byte *data);
 
       std::queue<Byte*> m_queue;
       Lock m_lock;
@@ -17,6 +17,8 @@ public:
 
       virtual void globalSend(SInt32 dest_proc, const void *buffer, UInt32 length) = 0;
       virtual void send(core_id_t dest, const void *buffer, UInt32 length) = 0;
+      // Same as send, but the transport takes over buffer (allocated with new[]) rather than copying it
+      virtual void sendOwned(core_id_t dest, Byte *buffer, UInt32 length) { send(dest, buffer, length); delete [] buffer; }
       virtual Byte* recv() = 0;
       virtual bool query() = 0;
 
@@ -370,7 +370,25 @@ void openFile(THREADID threadid)
    #else
       const bool arch32 = false;
    #endif
-   thread_data[threadid].output = new Sift::Writer(filename, getCode, KnobUseResponseFiles.Value() ? false : true, response_filename, threadid, arch32, false, KnobSendPhysicalAddresses.Value());
+   // Block-compressed, indexed traces are only written to files: live traces through response files stay uncompressed
+   int block_codec = -1;
+   if (KnobTraceCodec.Value() != "" && !KnobUseResponseFiles.Value())
+   {
+      if (KnobTraceCodec.Value() == "none")
+         block_codec = Sift::BlockCodecNone;
+      else if (KnobTraceCodec.Value() == "zlib")
+         block_codec = Sift::BlockCodecZlib;
+      else if (KnobTraceCodec.Value() == "zstd")
+         block_codec = Sift::BlockCodecZstd;
+      else if (KnobTraceCodec.Value() == "lz4")
+         block_codec = Sift::BlockCodecLz4;
+      else
+      {
+         std::cerr << "[SIFT_RECORDER:" << app_id << "] Error: Unknown trace codec " << KnobTraceCodec.Value() << std::endl;
+         exit(1);
+      }
+   }
+   thread_data[threadid].output = new Sift::Writer(filename, getCode, KnobUseResponseFiles.Value() ? false : true, response_filename, threadid, arch32, false, KnobSendPhysicalAddresses.Value(), NULL, NULL, block_codec);
 
    if (!thread_data[threadid].output->IsOpen())
    {
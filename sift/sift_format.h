@@ -18,6 +18,23 @@
 # define SIFT_USE_ZLIB 1
 #endif
 
+// Memory-mapped trace input, only used by the reader (not needed in the PinCRT-based recorder)
+#if defined(PIN_CRT)
+# define SIFT_USE_MMAP 0
+#else
+# define SIFT_USE_MMAP 1
+#endif
+
+// Optional codecs for block-compressed traces, enabled by the build when their libraries are installed
+#if !defined(SIFT_USE_ZSTD) || defined(PIN_CRT)
+# undef SIFT_USE_ZSTD
+# define SIFT_USE_ZSTD 0
+#endif
+#if !defined(SIFT_USE_LZ4) || defined(PIN_CRT)
+# undef SIFT_USE_LZ4
+# define SIFT_USE_LZ4 0
+#endif
+
 namespace Sift
 {
 
@@ -42,8 +59,53 @@ namespace Sift
       ArchIA32 = 2,
       IcacheVariable = 4,
       PhysicalAddress = 8,
+      BlockIndex = 16,
    } Option;
 
+   // Block-compressed traces (option BlockIndex)
+   //
+   // The body is a sequence of blocks, each compressed on its own and holding complete records. Every block can be
+   // decoded without the ones before it: it starts with an extended instruction record, and resends the code pages,
+   // address mappings and ISA its instructions need. A block header with size zero ends the sequence. It is followed
+   // by one index entry per block and, at the very end of the file, by the index trailer.
+
+   typedef enum
+   {
+      BlockCodecNone = 0,
+      BlockCodecZlib = 1,
+      BlockCodecZstd = 2,
+      BlockCodecLz4 = 3,
+   } BlockCodec;
+
+   typedef enum
+   {
+      BlockHasEvents = 1,        //< Block has records other than instructions, code, address mappings and ISA changes
+   } BlockFlags;
+
+   const uint32_t BlockIndexMagic = 0x58494653; // "SFIX"
+
+   typedef struct
+   {
+      uint32_t size;             //< Size of the compressed data, zero for the end of the blocks
+      uint32_t raw_size;         //< Size of the decompressed data
+      uint8_t codec;             //< BlockCodec
+   } __attribute__ ((__packed__)) BlockHeader;
+
+   typedef struct
+   {
+      uint64_t offset;           //< File offset of the block header
+      uint64_t icount;           //< Instructions before this block
+      uint32_t flags;            //< Bit field of BlockFlags
+   } __attribute__ ((__packed__)) BlockIndexEntry;
+
+   typedef struct
+   {
+      uint64_t offset;           //< File offset of the first index entry
+      uint64_t num_blocks;
+      uint64_t icount;           //< Instructions in the trace
+      uint32_t magic;
+   } __attribute__ ((__packed__)) BlockIndexTrailer;
+
    typedef union
    {
       // Simple format for common instructions
@@ -7,6 +7,7 @@
 #include <fstream>
 #include <cassert>
 #include <cstring>
+#include <algorithm>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -41,11 +42,20 @@ Sift::Reader::Reader(const char *filename, const char *response_filename, uint32
    , handleRoutineAnnounceFunc(NULL)
    , handleRoutineArg(NULL)   
    , filesize(0)
+   , inputstream(NULL)
+   , mappedstream(NULL)
+   , blockstream(NULL)
    , last_address(0)
    , icache()
    , m_id(id)
    , m_trace_has_pa(false)
+   , m_is_file(false)
    , m_seen_end(false)
+   , m_icount(0)
+   , m_read_ahead(false)
+   , m_have_pending(false)
+   , m_pending_type(0)
+   , m_pending_size(0)
    , m_last_sinst(NULL)
    , m_isa(0)
 {
@@ -80,19 +90,42 @@ bool Sift::Reader::initStream()
    std::cerr << "[DEBUG:" << m_id << "] InitStream Attempting Open" << std::endl;
    #endif
 
-   inputstream = new std::ifstream(m_filename, std::ios::in);
+   struct stat filestatus;
+   bool have_stat = stat(m_filename, &filestatus) == 0;
 
-   if ((!inputstream->is_open()) || (!inputstream->good()))
+#if SIFT_USE_MMAP
+   // Traces on disk are decoded straight from memory, pipes (live traces) go through an ifstream
+   if (have_stat && S_ISREG(filestatus.st_mode))
    {
-      std::cerr << "[SIFT:" << m_id << "] Cannot open " << m_filename << "\n";
-      return false;
+      mappedstream = new vimstream(m_filename);
+      if (mappedstream->is_open())
+      {
+         input = mappedstream;
+      }
+      else
+      {
+         delete mappedstream;
+         mappedstream = NULL;
+      }
    }
+#endif
 
-   struct stat filestatus;
-   stat(m_filename, &filestatus);
-   filesize = filestatus.st_size;
+   if (!input)
+   {
+      inputstream = new std::ifstream(m_filename, std::ios::in);
+
+      if ((!inputstream->is_open()) || (!inputstream->good()))
+      {
+         std::cerr << "[SIFT:" << m_id << "] Cannot open " << m_filename << "\n";
+         return false;
+      }
+
+      input = new vifstream(inputstream);
+   }
 
-   input = new vifstream(inputstream);
+   if (have_stat)
+      filesize = filestatus.st_size;
+   m_is_file = have_stat && S_ISREG(filestatus.st_mode);
 
    Sift::Header hdr;
    input->read(reinterpret_cast<char*>(&hdr), sizeof(hdr));
@@ -119,6 +152,14 @@ bool Sift::Reader::initStream()
    }
 #endif
 
+   if (hdr.options & BlockIndex)
+   {
+      input = blockstream = new ibstream(input, sizeof(hdr));
+      if (have_stat && S_ISREG(filestatus.st_mode))
+         blockstream->loadIndex(filesize);
+      hdr.options &= ~BlockIndex;
+   }
+
    if (hdr.options & ArchIA32)
    {
       hdr.options &= ~ArchIA32;
@@ -180,7 +221,7 @@ bool Sift::Reader::Read(Instruction &inst)
    while(!m_seen_end)
    {
       Record rec;
-      uint8_t byte = input->peek();
+      uint8_t byte = m_have_pending ? 0 : input->peek();
       if (input->fail())
       {
          std::cerr << "[SIFT:" << m_id << "] Error: " << strerror(errno) << "\n";
@@ -190,7 +231,26 @@ bool Sift::Reader::Read(Instruction &inst)
       if (byte == 0)
       {
          // Other
-         input->read(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
+         if (m_have_pending)
+         {
+            rec.Other.zero = 0;
+            rec.Other.type = m_pending_type;
+            rec.Other.size = m_pending_size;
+            m_have_pending = false;
+         }
+         else
+         {
+            input->read(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
+         }
+
+         if (m_read_ahead && rec.Other.type != RecOtherIcache && rec.Other.type != RecOtherIcacheVariable && rec.Other.type != RecOtherISAChange)
+         {
+            m_pending_type = rec.Other.type;
+            m_pending_size = rec.Other.size;
+            m_have_pending = true;
+            return false;
+         }
+
          switch(rec.Other.type)
          {
             case RecOtherEnd:
@@ -203,10 +263,12 @@ bool Sift::Reader::Read(Instruction &inst)
             {
                assert(rec.Other.size == sizeof(uint64_t) + ICACHE_SIZE);
                uint64_t address;
-               uint8_t *bytes = new uint8_t[ICACHE_SIZE];
                input->read(reinterpret_cast<char*>(&address), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(bytes), ICACHE_SIZE);
-               icache[address] = bytes;
+               // Block-compressed traces send a page again in every block that uses it
+               const uint8_t *&bytes = icache[address];
+               if (bytes == NULL)
+                  bytes = new uint8_t[ICACHE_SIZE];
+               input->read(const_cast<char*>(reinterpret_cast<const char*>(bytes)), ICACHE_SIZE);
                break;
             }
             case RecOtherIcacheVariable:
@@ -283,14 +345,12 @@ bool Sift::Reader::Read(Instruction &inst)
                std::cerr << "[DEBUG:" << m_id << "] Read Output" << std::endl;
                #endif
                assert(rec.Other.size > sizeof(uint8_t));
-               uint8_t fd;
                uint32_t size = rec.Other.size - sizeof(uint8_t);
-               uint8_t *bytes = new uint8_t[size];
-               input->read(reinterpret_cast<char*>(&fd), sizeof(uint8_t));
-               input->read(reinterpret_cast<char*>(bytes), size);
+               const uint8_t *bytes = reinterpret_cast<const uint8_t*>(input->readBuffer(rec.Other.size));
+               if (bytes == NULL)
+                  return false;
                if (handleOutputFunc)
-                  handleOutputFunc(handleOutputArg, fd, bytes, size);
-               delete [] bytes;
+                  handleOutputFunc(handleOutputArg, bytes[0], bytes + sizeof(uint8_t), size);
                break;
             }
             case RecOtherSyscallRequest:
@@ -301,7 +361,10 @@ bool Sift::Reader::Read(Instruction &inst)
                assert(rec.Other.size > sizeof(uint16_t));
                uint16_t syscall_number;
                uint32_t size = rec.Other.size - sizeof(uint16_t);
-               uint8_t *bytes = new uint8_t[size];
+               // The syscall handler can access memory through this stream, so copy the arguments out
+               if (m_payload.size() < size)
+                  m_payload.resize(size);
+               uint8_t *bytes = m_payload.data();
                input->read(reinterpret_cast<char*>(&syscall_number), sizeof(uint16_t));
                input->read(reinterpret_cast<char*>(bytes), size);
                #if VERBOSE_HEX > 0
@@ -325,7 +388,6 @@ bool Sift::Reader::Read(Instruction &inst)
                   uint64_t ret = handleSyscallFunc(handleSyscallArg, syscall_number, bytes, size);
                   sendSyscallResponse(ret);
                }
-               delete [] bytes;
                break;
             }
             case RecOtherNewThread:
@@ -438,27 +500,31 @@ bool Sift::Reader::Read(Instruction &inst)
             }
             case RecOtherRoutineAnnounce:
             {
+               // Decode the whole record in place, checking every field against the record size
+               const char *data = input->readBuffer(rec.Other.size);
+               if (data == NULL)
+                  return false;
+               const char *end = data + rec.Other.size;
                uint64_t eip, offset;
                uint16_t len_name, len_imgname, len_filename;
-               char *name, *imgname, *filename;
+               const char *name, *imgname, *filename;
                uint32_t line, column;
-               input->read(reinterpret_cast<char*>(&eip), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&len_name), sizeof(uint16_t));
-               name = (char*)malloc(len_name);
-               input->read(name, len_name);
-               input->read(reinterpret_cast<char*>(&len_imgname), sizeof(uint16_t));
-               imgname = (char*)malloc(len_imgname);
-               input->read(imgname, len_imgname);
-               input->read(reinterpret_cast<char*>(&offset), sizeof(uint64_t));
-               input->read(reinterpret_cast<char*>(&line), sizeof(uint32_t));
-               input->read(reinterpret_cast<char*>(&column), sizeof(uint32_t));
-               input->read(reinterpret_cast<char*>(&len_filename), sizeof(uint16_t));
-               filename = (char*)malloc(len_filename);
-               input->read(filename, len_filename);
+               assert(data + sizeof(uint64_t) + sizeof(uint16_t) <= end);
+               memcpy(&eip, data, sizeof(uint64_t)); data += sizeof(uint64_t);
+               memcpy(&len_name, data, sizeof(uint16_t)); data += sizeof(uint16_t);
+               name = data; data += len_name;
+               assert(data + sizeof(uint16_t) <= end);
+               memcpy(&len_imgname, data, sizeof(uint16_t)); data += sizeof(uint16_t);
+               imgname = data; data += len_imgname;
+               assert(data + sizeof(uint64_t) + 2 * sizeof(uint32_t) + sizeof(uint16_t) <= end);
+               memcpy(&offset, data, sizeof(uint64_t)); data += sizeof(uint64_t);
+               memcpy(&line, data, sizeof(uint32_t)); data += sizeof(uint32_t);
+               memcpy(&column, data, sizeof(uint32_t)); data += sizeof(uint32_t);
+               memcpy(&len_filename, data, sizeof(uint16_t)); data += sizeof(uint16_t);
+               filename = data; data += len_filename;
+               assert(data <= end);
                if (handleRoutineAnnounceFunc)
                   handleRoutineAnnounceFunc(handleRoutineArg, eip, name, imgname, offset, line, column, filename);
-               free(name);
-               free(filename);
                break;
             }            
             case RecOtherISAChange:
@@ -472,9 +538,8 @@ bool Sift::Reader::Read(Instruction &inst)
             }
             default:
             {
-               uint8_t *bytes = new uint8_t[rec.Other.size];
-               input->read(reinterpret_cast<char*>(bytes), rec.Other.size);
-               delete [] bytes;
+               if (input->readBuffer(rec.Other.size) == NULL)
+                  return false;
                break;
             }
          }
@@ -486,21 +551,25 @@ bool Sift::Reader::Read(Instruction &inst)
 
       if ((byte & 0xf) != 0)
       {
-         // Instruction
-         input->read(reinterpret_cast<char*>(&rec), sizeof(rec.Instruction));
+         // Instruction: the first byte gives the number of addresses, get the complete record in one go
+         const Record *irec = reinterpret_cast<const Record*>(input->readBuffer(sizeof(rec.Instruction) + ((byte >> 4) & 0x3) * sizeof(uint64_t)));
+         if (irec == NULL)
+            return false;
 
          #if VERBOSE_HEX > 2
-         hexdump(&rec, sizeof(rec.Instruction));
+         hexdump(irec, sizeof(rec.Instruction));
          #endif
 
-         size = rec.Instruction.size;
+         size = irec->Instruction.size;
          addr = last_address;
-         inst.num_addresses = rec.Instruction.num_addresses;
-         inst.is_branch = rec.Instruction.is_branch;
-         inst.taken = rec.Instruction.taken;
+         inst.num_addresses = irec->Instruction.num_addresses;
+         inst.is_branch = irec->Instruction.is_branch;
+         inst.taken = irec->Instruction.taken;
          inst.is_predicate = false;
          inst.executed = true;
          inst.isa = m_isa;
+         assert(inst.num_addresses <= MAX_DYNAMIC_ADDRESSES);
+         memcpy(inst.addresses, reinterpret_cast<const char*>(irec) + sizeof(rec.Instruction), inst.num_addresses * sizeof(uint64_t));
       }
       else
       {
@@ -521,14 +590,15 @@ bool Sift::Reader::Read(Instruction &inst)
          inst.isa = m_isa;
 
          last_address = addr;
+
+         assert(inst.num_addresses <= MAX_DYNAMIC_ADDRESSES);
+         input->read(reinterpret_cast<char*>(inst.addresses), inst.num_addresses * sizeof(uint64_t));
       }
 
       last_address += size;
 
-      for(int i = 0; i < inst.num_addresses; ++i)
-         input->read(reinterpret_cast<char*>(&inst.addresses[i]), sizeof(uint64_t));
-
       inst.sinst = getStaticInstruction(addr, size);
+      m_icount++;
 
       #if VERBOSE_HEX > 2
       hexdump(inst.sinst->data, inst.sinst->size);
@@ -545,6 +615,60 @@ bool Sift::Reader::Read(Instruction &inst)
    return true;
 }
 
+size_t Sift::Reader::ReadAhead(Instruction *insts, size_t count)
+{
+   m_read_ahead = true;
+   size_t n = 0;
+   while(n < count && Read(insts[n]))
+      ++n;
+   m_read_ahead = false;
+   return n;
+}
+
+bool Sift::Reader::Seek(uint64_t icount)
+{
+   if (input == NULL)
+   {
+      if (!initStream())
+      {
+         std::cerr << "[SIFT:" << m_id << "] Error: initStream failed\n";
+         return false;
+      }
+   }
+
+   const std::vector<BlockIndexEntry> *index = getBlockIndex();
+   if (index && !index->empty())
+   {
+      // Last block that starts at or before the target, jump there unless reading on gets there sooner
+      size_t block = std::upper_bound(index->begin(), index->end(), icount,
+                                      [](uint64_t icount, const BlockIndexEntry &entry) { return icount < entry.icount; })
+                   - index->begin();
+      if (block > 0 && (icount < m_icount || (*index)[block - 1].icount > m_icount))
+      {
+         if (!blockstream->seekBlock(block - 1))
+            return false;
+         // Blocks start from scratch: an extended instruction record, and the ISA if it is not the default
+         m_icount = (*index)[block - 1].icount;
+         m_seen_end = false;
+         m_last_sinst = NULL;
+         last_address = 0;
+         m_have_pending = false;
+         m_isa = 0;
+      }
+   }
+
+   if (icount < m_icount)
+      return false;
+
+   Instruction inst;
+   while(m_icount < icount)
+   {
+      if (!Read(inst))
+         return false;
+   }
+   return true;
+}
+
 bool Sift::Reader::AccessMemory(MemoryLockType lock_signal, MemoryOpType mem_op, uint64_t d_addr, uint8_t *data_buffer, uint32_t data_size)
 {
    #if VERBOSE > 0
@@ -768,7 +892,9 @@ void Sift::Reader::sendSimpleResponse(RecOtherType type, void *data, uint32_t si
 
 uint64_t Sift::Reader::getPosition()
 {
-   if (inputstream)
+   if (mappedstream)
+      return mappedstream->tell();
+   else if (inputstream)
       return inputstream->tellg();
    else
       return 0;
@@ -779,6 +905,19 @@ uint64_t Sift::Reader::getLength()
    return filesize;
 }
 
+uint64_t Sift::Reader::getTraceInstructionCount()
+{
+   const std::vector<BlockIndexEntry> *index = getBlockIndex();
+   return index ? blockstream->getInstructionCount() : 0;
+}
+
+const std::vector<Sift::BlockIndexEntry>* Sift::Reader::getBlockIndex()
+{
+   if (input == NULL && !initStream())
+      return NULL;
+   return (blockstream && !blockstream->getIndex().empty()) ? &blockstream->getIndex() : NULL;
+}
+
 uint64_t Sift::Reader::va2pa(uint64_t va)
 {
    if (m_trace_has_pa)
@@ -5,10 +5,13 @@
 #include "sift_format.h"
 
 #include <unordered_map>
+#include <vector>
 #include <fstream>
 #include <cassert>
 
 class vistream;
+class vimstream;
+class ibstream;
 class vostream;
 
 namespace Sift
@@ -78,6 +81,9 @@ namespace Sift
          void *handleRoutineArg;
          uint64_t filesize;
          std::ifstream *inputstream;
+         vimstream *mappedstream;  // Set when the trace file is memory-mapped
+         ibstream *blockstream;  // Set for block-compressed traces
+         std::vector<uint8_t> m_payload;  // Reused for record payloads passed to callbacks
 
          char *m_filename;
          char *m_response_filename;
@@ -90,7 +96,13 @@ namespace Sift
          uint32_t m_id;
 
          bool m_trace_has_pa;
+         bool m_is_file;
          bool m_seen_end;
+         uint64_t m_icount;
+         bool m_read_ahead;  // In ReadAhead: stop at records that need the caller
+         bool m_have_pending;  // Record header read by ReadAhead, to be handled by the next Read
+         uint8_t m_pending_type;
+         uint32_t m_pending_size;
          const StaticInstruction *m_last_sinst;
          
          int m_isa;
@@ -107,6 +119,16 @@ namespace Sift
          ~Reader();
          bool initStream();
          bool Read(Instruction&);
+         // Decode up to count instructions, handling only records that need no callback or response (code pages,
+         // ISA changes). Stops early at any other record or at the end of the trace: the next Read handles it.
+         // Can run on another thread than Read, as long as the two never run at the same time.
+         size_t ReadAhead(Instruction *insts, size_t count);
+         // Position the trace so that the next Read returns instruction number icount (counting from zero).
+         // With a block index this jumps to the last block starting at or before it, which also allows going back.
+         // The rest of the way is read with Read, so the callbacks of the records there do fire (syscalls, magic,
+         // thread events, ...) and send their responses; only the records of the blocks jumped over are not handled.
+         // Without an index the target cannot be behind the current instruction.
+         bool Seek(uint64_t icount);
          bool AccessMemory(MemoryLockType lock_signal, MemoryOpType mem_op, uint64_t d_addr, uint8_t *data_buffer, uint32_t data_size);
 
          void setHandleInstructionCountFunc(HandleInstructionCountFunc func, void* arg = NULL) { handleInstructionCountFunc = func; handleInstructionCountArg = arg; }
@@ -122,7 +144,14 @@ namespace Sift
 
          uint64_t getPosition();
          uint64_t getLength();
+         // Instructions read (or skipped by Seek) so far
+         uint64_t getInstructionCount() const { return m_icount; }
+         // Instructions in the trace and block index, if the trace has one (both empty otherwise)
+         uint64_t getTraceInstructionCount();
+         const std::vector<BlockIndexEntry>* getBlockIndex();
          bool getTraceHasPhysicalAddresses() const { return m_trace_has_pa; }
+         // Whether the trace is a file on disk, false for a pipe fed by a live frontend (or until the trace is opened)
+         bool isFile() const { return m_is_file; }
          uint64_t va2pa(uint64_t va);
    };
 };
@@ -39,7 +39,7 @@ __sift_assert_fail(__const char *__assertion, __const char *__file,
 }
 
 
-Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useCompression, const char *response_filename, uint32_t id, bool arch32, bool requires_icache_per_insn, bool send_va2pa_mapping, GetCodeFunc2 getCodeFunc2, void* getCodeFunc2Data)
+Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useCompression, const char *response_filename, uint32_t id, bool arch32, bool requires_icache_per_insn, bool send_va2pa_mapping, GetCodeFunc2 getCodeFunc2, void* getCodeFunc2Data, int blockCodec)
    : response(NULL)
    , getCodeFunc(getCodeFunc)
    , getCodeFunc2(getCodeFunc2)
@@ -56,6 +56,9 @@ Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useComp
    , m_id(id)
    , m_requires_icache_per_insn(requires_icache_per_insn)
    , m_send_va2pa_mapping(send_va2pa_mapping)
+   , m_blockstream(NULL)
+   , m_block(0)
+   , m_isa(0)
 {
    memset(hsize, 0, sizeof(hsize));
    memset(haddr, 0, sizeof(haddr));
@@ -71,6 +74,17 @@ Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useComp
       std::cerr << "[SIFT:" << m_id << "] Warning: Compression disabled, ignoring request.\n";
    }
 #endif
+   if (blockCodec >= 0)
+   {
+      if (!obstream::supported(blockCodec))
+      {
+         std::cerr << "[SIFT:" << m_id << "] Warning: Block codec " << blockCodec << " not available, storing blocks uncompressed.\n";
+         blockCodec = BlockCodecNone;
+      }
+      // Blocks are compressed on their own
+      options &= ~CompressionZlib;
+      options |= BlockIndex;
+   }
    if (arch32)
       options |= ArchIA32;
    if (requires_icache_per_insn)
@@ -99,7 +113,9 @@ Sift::Writer::Writer(const char *filename, GetCodeFunc getCodeFunc, bool useComp
    output->write(reinterpret_cast<char*>(&hdr), sizeof(hdr));
    output->flush();
 
-   if (options & CompressionZlib)
+   if (options & BlockIndex)
+      output = m_blockstream = new obstream(output, blockCodec, sizeof(hdr));
+   else if (options & CompressionZlib)
       output = new ozstream(output);
 }
 
@@ -120,6 +136,39 @@ void Sift::Writer::initResponse()
    }
 }
 
+void Sift::Writer::checkBlock()
+{
+   if (!m_blockstream)
+   {
+      return;
+   }
+
+   if (m_blockstream->full())
+   {
+      m_blockstream->endBlock();
+   }
+
+   // Every block decodes on its own: start over with an extended instruction record, and resend code pages,
+   // address mappings and the ISA
+   if (m_blockstream->blocks() != m_block)
+   {
+      m_block = m_blockstream->blocks();
+      last_address = 0;
+      icache.clear();
+      m_va2pa.clear();
+      if (m_isa != 0)
+         ISAChange(m_isa);
+   }
+}
+
+void Sift::Writer::markEvent()
+{
+   if (m_blockstream)
+   {
+      m_blockstream->addFlags(BlockHasEvents);
+   }
+}
+
 void Sift::Writer::End()
 {
    #if VERBOSE > 0
@@ -157,6 +206,7 @@ void Sift::Writer::End()
    {
       delete output;
       output = NULL;
+      m_blockstream = NULL;
    }
 }
 
@@ -188,6 +238,8 @@ void Sift::Writer::Instruction(uint64_t addr, uint8_t size, uint8_t num_addresse
       return;
    }
 
+   checkBlock();
+
    if (m_requires_icache_per_insn)
    {
       if (! icache[addr])
@@ -309,6 +361,8 @@ void Sift::Writer::Instruction(uint64_t addr, uint8_t size, uint8_t num_addresse
    last_address += size;
 
    ninstrs++;
+   if (m_blockstream)
+      m_blockstream->addInstruction();
    hsize[size]++;
    haddr[num_addresses]++;
    if (is_branch)
@@ -328,6 +382,8 @@ Sift::Mode Sift::Writer::InstructionCount(uint32_t icount)
       return Sift::ModeUnknown;
    }
 
+   markEvent();
+
    Record rec;
    rec.Other.zero = 0;
    rec.Other.type = RecOtherInstructionCount;
@@ -375,6 +431,8 @@ void Sift::Writer::CacheOnly(uint8_t icount, CacheOnlyType type, uint64_t eip, u
       return;
    }
 
+   checkBlock();
+
    send_va2pa(eip);
    send_va2pa(address);
 
@@ -411,6 +469,8 @@ void Sift::Writer::Output(uint8_t fd, const char *data, uint32_t size)
       return;
    }
 
+   markEvent();
+
    Record rec;
    rec.Other.zero = 0;
    rec.Other.type = RecOtherOutput;
@@ -438,6 +498,8 @@ int32_t Sift::Writer::NewThread()
       return -1;
    }
 
+   markEvent();
+
    Record rec;
    rec.Other.zero = 0;
    rec.Other.type = RecOtherNewThread;
@@ -501,6 +563,8 @@ uint64_t Sift::Writer::Syscall(uint16_t syscall_number, const char *data, uint32
       return 1;
    }
 
+   markEvent();
+
    // Try to send some extra logical2physical address mappings for data referenced by system call arguments.
    // Also try to read from the address first, if the mapping wasn't set up yet (never accessed before, or swapped out),
    // then this will cause a page fault that brings in the data.
@@ -585,6 +649,8 @@ int32_t Sift::Writer::Join(int32_t thread)
       return -1;
    }
 
+   markEvent();
+
    Record rec;
    rec.Other.zero = 0;
    rec.Other.type = RecOtherJoin;
@@ -639,6 +705,8 @@ Sift::Mode Sift::Writer::Sync()
       return Sift::ModeUnknown;
    }
 
+   markEvent();
+
    // send sync
    Record rec;
    rec.Other.zero = 0;
@@ -695,6 +763,8 @@ int32_t Sift::Writer::Fork()
       return -1;
    }
 
+   markEvent();
+
    Record rec;
    rec.Other.zero = 0;
    rec.Other.type = RecOtherFork;
@@ -740,6 +810,8 @@ uint64_t Sift::Writer::Magic(uint64_t a, uint64_t b, uint64_t c)
       return 1;
    }
 
+   markEvent();
+
    // send magic
    Record rec;
    rec.Other.zero = 0;
@@ -790,6 +862,8 @@ bool Sift::Writer::Emulate(Sift::EmuType type, Sift::EmuRequest &req, Sift::EmuR
       return false;
    }
 
+   markEvent();
+
    // send magic
    Record rec;
    rec.Other.zero = 0;
@@ -842,6 +916,8 @@ void Sift::Writer::RoutineChange(Sift::RoutineOpType event, uint64_t eip, uint64
       return;
    }
 
+   markEvent();
+
    Record rec;
    rec.Other.zero = 0;
    rec.Other.type = RecOtherRoutineChange;
@@ -861,6 +937,8 @@ void Sift::Writer::RoutineAnnounce(uint64_t eip, const char *name, const char *i
       return;
    }
 
+   markEvent();
+
    uint16_t len_name = strlen(name) + 1, len_imgname = strlen(imgname) + 1, len_filename = strlen(filename) + 1;
 
    Record rec;
@@ -903,6 +981,7 @@ void Sift::Writer::ISAChange(uint32_t new_isa)
 
    output->write(reinterpret_cast<char*>(&rec), sizeof(rec.Other));
    output->write(reinterpret_cast<char*>(&new_isa), sizeof(new_isa));
+   m_isa = new_isa;
 }
 
 bool Sift::Writer::IsOpen()
@@ -921,6 +1000,8 @@ void Sift::Writer::handleMemoryRequest(Record &respRec)
       return;
    }
 
+   markEvent();
+
    uint64_t addr;
    uint32_t size;
    MemoryLockType lock;
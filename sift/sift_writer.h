@@ -10,6 +10,7 @@
 
 class vistream;
 class vostream;
+class obstream;
 
 namespace Sift
 {
@@ -37,14 +38,21 @@ namespace Sift
          uint32_t m_id;
          bool m_requires_icache_per_insn;
          bool m_send_va2pa_mapping;
+         obstream *m_blockstream;  // Set when writing a block-compressed trace
+         uint64_t m_block;  // Block the delta state (last_address, icache, m_va2pa) was built for
+         uint32_t m_isa;
 
          void initResponse();
+         void checkBlock();
+         void markEvent();
          void handleMemoryRequest(Record &respRec);
          void send_va2pa(uint64_t va);
          uint64_t va2pa_lookup(uint64_t va);
 
       public:
-         Writer(const char *filename, GetCodeFunc getCodeFunc, bool useCompression = false, const char *response_filename = "", uint32_t id = 0, bool arch32 = false, bool requires_icache_per_insn = false, bool send_va2pa_mapping = false, GetCodeFunc2 getCodeFunc2 = NULL, void *GetCodeFunc2Data = NULL);
+         // blockCodec: a Sift::BlockCodec to write a block-compressed trace with an instruction index (overrides
+         // useCompression), or -1 for the plain format
+         Writer(const char *filename, GetCodeFunc getCodeFunc, bool useCompression = false, const char *response_filename = "", uint32_t id = 0, bool arch32 = false, bool requires_icache_per_insn = false, bool send_va2pa_mapping = false, GetCodeFunc2 getCodeFunc2 = NULL, void *GetCodeFunc2Data = NULL, int blockCodec = -1);
          ~Writer();
          void End();
          void Instruction(uint64_t addr, uint8_t size, uint8_t num_addresses, uint64_t addresses[], bool is_branch, bool taken, bool is_predicate, bool executed);
@@ -5,6 +5,7 @@
 #include <inttypes.h>
 #include <cassert>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <map>
 #include <unordered_map>
@@ -15,6 +16,35 @@ extern "C" {
 }
 #endif
 
+static void printInstruction(const Sift::Instruction &inst)
+{
+   //const xed_syntax_enum_t syntax = XED_SYNTAX_ATT;
+
+   printf("%016" PRIx64 " ", inst.sinst->addr);
+   char buffer[64] = {0};
+#if PIN_REV >= 67254
+   //xed_format_context(syntax, &inst.sinst->xed_inst, buffer, sizeof(buffer) - 1, inst.sinst->addr, 0, 0);
+#else
+   //xed_format(syntax, &inst.sinst->xed_inst, buffer, sizeof(buffer) - 1, inst.sinst->addr);
+#endif
+   printf("%-40s  ", buffer);
+
+   for(int i = 0; i < inst.sinst->size; ++i)
+      printf(" %02x", inst.sinst->data[i]);
+   printf("\n");
+
+   if (inst.num_addresses > 0) {
+      printf("                 -- addr");
+      for(int i = 0; i < inst.num_addresses; ++i)
+         printf(" %08" PRIx64, inst.addresses[i]);
+      printf("\n");
+   }
+   if (inst.is_branch)
+      printf("                 -- %s\n", inst.taken ? "taken" : "not taken");
+   if (inst.is_predicate)
+      printf("                 -- %s\n", inst.executed ? "executed" : "not executed");
+}
+
 int main(int argc, char* argv[])
 {
    if (argc > 1 && strcmp(argv[1], "-d") == 0)
@@ -65,41 +95,49 @@ int main(int argc, char* argv[])
          eip_last = it->first + it->second->size;
       }
    }
+   else if (argc > 2 && strcmp(argv[1], "-i") == 0)
+   {
+      Sift::Reader reader(argv[2]);
+      const std::vector<Sift::BlockIndexEntry> *index = reader.getBlockIndex();
+      if (!index)
+      {
+         fprintf(stderr, "%s has no block index\n", argv[2]);
+         return 1;
+      }
+
+      printf("%" PRIu64 " instructions in %zu blocks\n", reader.getTraceInstructionCount(), index->size());
+      printf("%8s %14s %16s  %s\n", "block", "offset", "first-insn", "flags");
+      for(size_t i = 0; i < index->size(); ++i)
+         printf("%8zu %14" PRIu64 " %16" PRIu64 "  %s\n", i, (*index)[i].offset, (*index)[i].icount, ((*index)[i].flags & Sift::BlockHasEvents) ? "events" : "");
+   }
+   else if (argc > 3 && strcmp(argv[1], "-r") == 0)
+   {
+      // Instruction range <first>[:<count>], a block index lets us jump straight to the first one
+      Sift::Reader reader(argv[3]);
+      char *end;
+      uint64_t first = strtoull(argv[2], &end, 0);
+      uint64_t count = (*end == ':') ? strtoull(end + 1, NULL, 0) : UINT64_MAX;
+
+      if (!reader.Seek(first))
+      {
+         fprintf(stderr, "Cannot seek to instruction %" PRIu64 "\n", first);
+         return 1;
+      }
+
+      Sift::Instruction inst;
+      for(uint64_t i = 0; i < count && reader.Read(inst); ++i)
+         printInstruction(inst);
+   }
    else if (argc > 1)
    {
       Sift::Reader reader(argv[1]);
-      //const xed_syntax_enum_t syntax = XED_SYNTAX_ATT;
 
       Sift::Instruction inst;
       while(reader.Read(inst))
-      {
-         printf("%016" PRIx64 " ", inst.sinst->addr);
-         char buffer[64] = {0};
-#if PIN_REV >= 67254
-         //xed_format_context(syntax, &inst.sinst->xed_inst, buffer, sizeof(buffer) - 1, inst.sinst->addr, 0, 0);
-#else
-         //xed_format(syntax, &inst.sinst->xed_inst, buffer, sizeof(buffer) - 1, inst.sinst->addr);
-#endif
-         printf("%-40s  ", buffer);
-
-         for(int i = 0; i < inst.sinst->size; ++i)
-            printf(" %02x", inst.sinst->data[i]);
-         printf("\n");
-
-         if (inst.num_addresses > 0) {
-            printf("                 -- addr");
-            for(int i = 0; i < inst.num_addresses; ++i)
-               printf(" %08" PRIx64, inst.addresses[i]);
-            printf("\n");
-         }
-         if (inst.is_branch)
-            printf("                 -- %s\n", inst.taken ? "taken" : "not taken");
-         if (inst.is_predicate)
-            printf("                 -- %s\n", inst.executed ? "executed" : "not executed");
-      }
+         printInstruction(inst);
    }
    else
    {
-      printf("Usage: %s [-d] <file.sift>\n", argv[0]);
+      printf("Usage: %s [-d | -i | -r <first>[:<count>]] <file.sift>\n", argv[0]);
    }
 }
@@ -1,6 +1,110 @@
 #include "zfstream.h"
 
 #include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#if SIFT_USE_ZSTD
+# include <zstd.h>
+#endif
+#if SIFT_USE_LZ4
+# include <lz4.h>
+#endif
+
+#if SIFT_USE_MMAP
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+const char* vistream::readBuffer(std::streamsize n)
+{
+   if (m_scratch.size() < size_t(n) || m_scratch.empty())
+      m_scratch.resize(n > 0 ? n : 1);
+   read(m_scratch.data(), n);
+   return fail() ? NULL : m_scratch.data();
+}
+
+vimstream::vimstream(const char * filename)
+   : m_data(NULL)
+   , m_size(0)
+   , m_pos(0)
+   , m_fail(false)
+{
+#if SIFT_USE_MMAP
+   int fd = open(filename, O_RDONLY);
+   if (fd < 0)
+      return;
+
+   struct stat filestatus;
+   if (fstat(fd, &filestatus) == 0 && S_ISREG(filestatus.st_mode) && filestatus.st_size > 0)
+   {
+      void *data = mmap(NULL, filestatus.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED)
+      {
+         madvise(data, filestatus.st_size, MADV_SEQUENTIAL);
+         m_data = static_cast<const char*>(data);
+         m_size = filestatus.st_size;
+      }
+   }
+   close(fd);
+#endif
+}
+
+vimstream::~vimstream()
+{
+#if SIFT_USE_MMAP
+   if (m_data)
+      munmap(const_cast<char*>(m_data), m_size);
+#endif
+}
+
+void vimstream::read(char* s, std::streamsize n)
+{
+   size_t avail = m_size - m_pos;
+   if (size_t(n) > avail)
+   {
+      memcpy(s, m_data + m_pos, avail);
+      m_pos = m_size;
+      m_fail = true;
+      return;
+   }
+   memcpy(s, m_data + m_pos, n);
+   m_pos += n;
+}
+
+int vimstream::peek()
+{
+   if (m_pos >= m_size)
+   {
+      m_fail = true;
+      return EOF;
+   }
+   return static_cast<unsigned char>(m_data[m_pos]);
+}
+
+const char* vimstream::readBuffer(std::streamsize n)
+{
+   if (size_t(n) > m_size - m_pos)
+   {
+      m_pos = m_size;
+      m_fail = true;
+      return NULL;
+   }
+   const char *data = m_data + m_pos;
+   m_pos += n;
+   return data;
+}
+
+bool vimstream::seek(uint64_t offset)
+{
+   if (offset > m_size)
+      return false;
+   m_pos = offset;
+   m_fail = false;
+   return true;
+}
 
 #if !SIFT_USE_ZLIB
 
@@ -26,7 +130,8 @@ izstream::izstream(vistream *input)
    : input(input)
    , m_eof(false)
    , m_fail(false)
-   , peek_valid(false)
+   , m_pos(0)
+   , m_len(0)
 {
 }
 
@@ -34,6 +139,11 @@ izstream::~izstream()
 {
 }
 
+bool izstream::fill(size_t n)
+{
+   return false;
+}
+
 void izstream::read(char* s, std::streamsize n)
 {
 }
@@ -43,6 +153,11 @@ int izstream::peek()
    return 0;
 }
 
+const char* izstream::readBuffer(std::streamsize n)
+{
+   return NULL;
+}
+
 #else /*SIFT_USE_ZLIB*/
 
 #include <zlib.h>
@@ -95,7 +210,9 @@ izstream::izstream(vistream *input)
    : input(input)
    , m_eof(false)
    , m_fail(false)
-   , peek_valid(false)
+   , m_block(blocksize)
+   , m_pos(0)
+   , m_len(0)
 {
    zstream.zalloc = Z_NULL;
    zstream.zfree = Z_NULL;
@@ -112,22 +229,20 @@ izstream::~izstream()
    delete input;
 }
 
-void izstream::read(char* s, std::streamsize n)
+bool izstream::fill(size_t n)
 {
-   if (peek_valid)
-   {
-      s[0] = peek_value;
-      peek_valid = false;
-      ++s;
-      --n;
-   }
-   if (n == 0)
-      return;
+   if (m_len - m_pos >= n)
+      return true;
 
-   zstream.next_out = (Bytef*)s;
-   zstream.avail_out = n;
+   // Move the unread data to the front, and grow the block if it is smaller than this read
+   memmove(m_block.data(), m_block.data() + m_pos, m_len - m_pos);
+   m_len -= m_pos;
+   m_pos = 0;
+   if (m_block.size() < n)
+      m_block.resize(n);
 
-   do
+   // Decompress as much as fits in the block, not just the n bytes asked for
+   while(m_len < n && !m_eof)
    {
       if (zstream.avail_in == 0) // If input data was left over from the previous call, use that up first
       {
@@ -135,28 +250,338 @@ void izstream::read(char* s, std::streamsize n)
          zstream.next_in = (Bytef*)buffer;
          zstream.avail_in = chunksize;
       }
+      zstream.next_out = (Bytef*)(m_block.data() + m_len);
+      zstream.avail_out = m_block.size() - m_len;
       int ret = inflate(&zstream, Z_NO_FLUSH);
-      if (ret == Z_STREAM_END) {
+      m_len = m_block.size() - zstream.avail_out;
+      if (ret == Z_STREAM_END)
          m_eof = true;
-         if (zstream.avail_out)
-         {
-            m_fail = true;
-            return;
-         }
-      } else
+      else
          assert(ret == Z_OK);
-   } while(zstream.avail_out != 0);
+   }
+
+   return m_len - m_pos >= n;
 }
 
-int izstream::peek()
+void izstream::read(char* s, std::streamsize n)
 {
-   if (peek_valid == true)
-      return peek_value;
+   if (!fill(n))
+   {
+      memcpy(s, m_block.data() + m_pos, m_len - m_pos);
+      m_pos = m_len;
+      m_fail = true;
+      return;
+   }
+   memcpy(s, m_block.data() + m_pos, n);
+   m_pos += n;
+}
 
-   read(&peek_value, 1);
-   peek_valid = true;
+int izstream::peek()
+{
+   if (!fill(1))
+   {
+      m_fail = true;
+      return EOF;
+   }
+   return static_cast<unsigned char>(m_block[m_pos]);
+}
 
-   return peek_value;
+const char* izstream::readBuffer(std::streamsize n)
+{
+   if (!fill(n))
+   {
+      m_pos = m_len;
+      m_fail = true;
+      return NULL;
+   }
+   const char *data = m_block.data() + m_pos;
+   m_pos += n;
+   return data;
 }
 
 #endif /*SIFT_USE_ZLIB*/
+
+
+// Compress src into dst, returns false if the codec is not compiled in
+static bool blockCompress(uint8_t codec, const char *src, size_t n, std::vector<char> &dst)
+{
+   switch(codec)
+   {
+      case Sift::BlockCodecNone:
+         dst.assign(src, src + n);
+         return true;
+#if SIFT_USE_ZLIB
+      case Sift::BlockCodecZlib:
+      {
+         uLongf size = compressBound(n);
+         dst.resize(size);
+         int ret = compress2((Bytef*)dst.data(), &size, (const Bytef*)src, n, Z_DEFAULT_COMPRESSION);
+         assert(ret == Z_OK);
+         dst.resize(size);
+         return true;
+      }
+#endif
+#if SIFT_USE_ZSTD
+      case Sift::BlockCodecZstd:
+      {
+         dst.resize(ZSTD_compressBound(n));
+         size_t size = ZSTD_compress(dst.data(), dst.size(), src, n, 3);
+         assert(!ZSTD_isError(size));
+         dst.resize(size);
+         return true;
+      }
+#endif
+#if SIFT_USE_LZ4
+      case Sift::BlockCodecLz4:
+      {
+         dst.resize(LZ4_compressBound(n));
+         int size = LZ4_compress_default(src, dst.data(), n, dst.size());
+         assert(size > 0);
+         dst.resize(size);
+         return true;
+      }
+#endif
+      default:
+         return false;
+   }
+}
+
+// Decompress exactly raw_size bytes from src into dst
+static bool blockDecompress(uint8_t codec, const char *src, size_t n, char *dst, size_t raw_size)
+{
+   switch(codec)
+   {
+      case Sift::BlockCodecNone:
+         if (n != raw_size)
+            return false;
+         memcpy(dst, src, n);
+         return true;
+#if SIFT_USE_ZLIB
+      case Sift::BlockCodecZlib:
+      {
+         uLongf size = raw_size;
+         return uncompress((Bytef*)dst, &size, (const Bytef*)src, n) == Z_OK && size == raw_size;
+      }
+#endif
+#if SIFT_USE_ZSTD
+      case Sift::BlockCodecZstd:
+      {
+         size_t size = ZSTD_decompress(dst, raw_size, src, n);
+         return !ZSTD_isError(size) && size == raw_size;
+      }
+#endif
+#if SIFT_USE_LZ4
+      case Sift::BlockCodecLz4:
+         return LZ4_decompress_safe(src, dst, n, raw_size) == int(raw_size);
+#endif
+      default:
+         return false;
+   }
+}
+
+obstream::obstream(vostream *output, uint8_t codec, uint64_t offset)
+   : output(output)
+   , m_codec(codec)
+   , m_offset(offset)
+   , m_icount(0)
+   , m_block_icount(0)
+   , m_block_flags(0)
+{
+   assert(supported(codec));
+   m_raw.reserve(blocksize);
+}
+
+obstream::~obstream()
+{
+   endBlock();
+
+   Sift::BlockHeader end = { 0, 0, m_codec };
+   writeBlock(end, NULL);
+
+   Sift::BlockIndexTrailer trailer = { m_offset, m_index.size(), m_icount, Sift::BlockIndexMagic };
+   output->write(reinterpret_cast<const char*>(m_index.data()), m_index.size() * sizeof(Sift::BlockIndexEntry));
+   output->write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+   output->flush();
+   delete output;
+}
+
+bool obstream::supported(uint8_t codec)
+{
+   switch(codec)
+   {
+      case Sift::BlockCodecNone:
+         return true;
+      case Sift::BlockCodecZlib:
+         return SIFT_USE_ZLIB;
+      case Sift::BlockCodecZstd:
+         return SIFT_USE_ZSTD;
+      case Sift::BlockCodecLz4:
+         return SIFT_USE_LZ4;
+      default:
+         return false;
+   }
+}
+
+void obstream::writeBlock(const Sift::BlockHeader &header, const char *data)
+{
+   output->write(reinterpret_cast<const char*>(&header), sizeof(header));
+   output->write(data, header.size);
+   m_offset += sizeof(header) + header.size;
+}
+
+void obstream::endBlock()
+{
+   if (m_raw.empty())
+      return;
+
+   Sift::BlockIndexEntry entry = { m_offset, m_block_icount, m_block_flags };
+   m_index.push_back(entry);
+
+   bool compressed = blockCompress(m_codec, m_raw.data(), m_raw.size(), m_compressed);
+   assert(compressed);
+   // Data that does not compress is stored as is
+   if (m_compressed.size() < m_raw.size())
+   {
+      Sift::BlockHeader header = { uint32_t(m_compressed.size()), uint32_t(m_raw.size()), m_codec };
+      writeBlock(header, m_compressed.data());
+   }
+   else
+   {
+      Sift::BlockHeader header = { uint32_t(m_raw.size()), uint32_t(m_raw.size()), Sift::BlockCodecNone };
+      writeBlock(header, m_raw.data());
+   }
+
+   m_raw.clear();
+   m_block_icount = m_icount;
+   m_block_flags = 0;
+}
+
+ibstream::ibstream(vistream *input, uint64_t offset)
+   : input(input)
+   , m_eof(false)
+   , m_fail(false)
+   , m_pos(0)
+   , m_len(0)
+   , m_offset(offset)
+   , m_icount(0)
+{
+}
+
+ibstream::~ibstream()
+{
+   delete input;
+}
+
+bool ibstream::fill(size_t n)
+{
+   while(m_len - m_pos < n && !m_eof)
+   {
+      Sift::BlockHeader header;
+      input->read(reinterpret_cast<char*>(&header), sizeof(header));
+      if (input->fail() || header.size == 0)
+      {
+         m_eof = true;
+         break;
+      }
+      const char *data = input->readBuffer(header.size);
+      if (data == NULL)
+      {
+         m_eof = true;
+         break;
+      }
+      m_offset += sizeof(header) + header.size;
+
+      // Records do not span blocks, but keep whatever is left in front of the new block
+      memmove(m_block.data(), m_block.data() + m_pos, m_len - m_pos);
+      m_len -= m_pos;
+      m_pos = 0;
+      if (m_block.size() < m_len + header.raw_size)
+         m_block.resize(m_len + header.raw_size);
+
+      if (!blockDecompress(header.codec, data, header.size, m_block.data() + m_len, header.raw_size))
+      {
+         fprintf(stderr, "[SIFT] Cannot decompress block at offset %" PRIu64 " (codec %u)\n", m_offset - sizeof(header) - header.size, header.codec);
+         m_eof = true;
+         break;
+      }
+      m_len += header.raw_size;
+   }
+
+   return m_len - m_pos >= n;
+}
+
+void ibstream::read(char* s, std::streamsize n)
+{
+   if (!fill(n))
+   {
+      memcpy(s, m_block.data() + m_pos, m_len - m_pos);
+      m_pos = m_len;
+      m_fail = true;
+      return;
+   }
+   memcpy(s, m_block.data() + m_pos, n);
+   m_pos += n;
+}
+
+int ibstream::peek()
+{
+   if (!fill(1))
+   {
+      m_fail = true;
+      return EOF;
+   }
+   return static_cast<unsigned char>(m_block[m_pos]);
+}
+
+const char* ibstream::readBuffer(std::streamsize n)
+{
+   if (!fill(n))
+   {
+      m_pos = m_len;
+      m_fail = true;
+      return NULL;
+   }
+   const char *data = m_block.data() + m_pos;
+   m_pos += n;
+   return data;
+}
+
+bool ibstream::loadIndex(uint64_t filesize)
+{
+   Sift::BlockIndexTrailer trailer;
+   if (filesize < sizeof(trailer) || !input->seek(filesize - sizeof(trailer)))
+      return false;
+
+   // A trace that is still being written, or was cut short, has no valid trailer
+   input->read(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+   bool valid = !input->fail()
+             && trailer.magic == Sift::BlockIndexMagic
+             && trailer.offset + trailer.num_blocks * sizeof(Sift::BlockIndexEntry) + sizeof(trailer) == filesize;
+   if (valid)
+   {
+      m_index.resize(trailer.num_blocks);
+      input->seek(trailer.offset);
+      input->read(reinterpret_cast<char*>(m_index.data()), trailer.num_blocks * sizeof(Sift::BlockIndexEntry));
+      valid = !input->fail();
+   }
+
+   if (valid)
+      m_icount = trailer.icount;
+   else
+      m_index.clear();
+
+   input->seek(m_offset);
+   return valid;
+}
+
+bool ibstream::seekBlock(size_t block)
+{
+   if (block >= m_index.size() || !input->seek(m_index[block].offset))
+      return false;
+
+   m_offset = m_index[block].offset;
+   m_pos = m_len = 0;
+   m_eof = false;
+   m_fail = false;
+   return true;
+}
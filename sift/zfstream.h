@@ -6,6 +6,7 @@
 #include <ostream>
 #include <istream>
 #include <fstream>
+#include <vector>
 
 #if SIFT_USE_ZLIB
 # include <zlib.h>
@@ -68,11 +69,18 @@ class ozstream : public vostream
 
 class vistream
 {
+   private:
+      std::vector<char> m_scratch;
    public:
       virtual ~vistream() {}
       virtual void read(char* s, std::streamsize n) = 0;
       virtual int peek() = 0;
       virtual bool fail() const = 0;
+      // Move to an absolute offset, returns false if the stream cannot seek (e.g. a pipe)
+      virtual bool seek(uint64_t offset) { return false; }
+      // Read n bytes without copying them out: the pointer stays valid until the next call on this stream.
+      // Returns NULL if fewer than n bytes are left. The default implementation reads into a reusable buffer.
+      virtual const char* readBuffer(std::streamsize n);
 };
 
 class vifstream : public vistream
@@ -90,8 +98,31 @@ class vifstream : public vistream
       virtual int peek()
          { return stream->peek(); }
       virtual bool fail() const { return stream->fail(); }
+      virtual bool seek(uint64_t offset)
+         { stream->clear(); stream->seekg(offset); return !stream->fail(); }
 };
 
+// Regular file mapped in memory: reads copy (or, with readBuffer, point) straight from the mapping
+class vimstream : public vistream
+{
+   private:
+      const char *m_data;
+      size_t m_size;
+      size_t m_pos;
+      bool m_fail;
+   public:
+      vimstream(const char * filename);
+      virtual ~vimstream();
+      bool is_open() const { return m_data != NULL; }
+      uint64_t tell() const { return m_pos; }
+      virtual void read(char* s, std::streamsize n);
+      virtual int peek();
+      virtual const char* readBuffer(std::streamsize n);
+      virtual bool fail() const { return m_fail; }
+      virtual bool seek(uint64_t offset);
+};
+
+// Decompresses in large blocks into a reusable buffer, reads are served from that buffer
 class izstream : public vistream
 {
    private:
@@ -102,16 +133,84 @@ class izstream : public vistream
       z_stream zstream;
 #endif
       static const size_t chunksize = 64*1024;
+      static const size_t blocksize = 1024*1024;
       char buffer[chunksize];
-      char peek_value;
-      bool peek_valid;
+      std::vector<char> m_block;
+      size_t m_pos;  // Next byte to read from m_block
+      size_t m_len;  // End of the decompressed data in m_block
+      bool fill(size_t n);
    public:
       izstream(vistream *input);
       virtual ~izstream();
       virtual void read(char* s, std::streamsize n);
       virtual int peek();
+      virtual const char* readBuffer(std::streamsize n);
       virtual bool eof() const { return m_eof; }
       virtual bool fail() const { return m_fail; }
 };
 
+// Block-compressed output (Sift::BlockIndex): data is collected into blocks that are compressed on their own,
+// a block ends on flush() or, when the writer checks full() at a record boundary, with endBlock().
+// Closing the stream writes the block index.
+class obstream : public vostream
+{
+   private:
+      vostream *output;
+      uint8_t m_codec;
+      uint64_t m_offset;         // File offset of the next block
+      uint64_t m_icount;         // Instructions written so far
+      uint64_t m_block_icount;   // Instructions before the current block
+      uint32_t m_block_flags;
+      std::vector<char> m_raw;
+      std::vector<char> m_compressed;
+      std::vector<Sift::BlockIndexEntry> m_index;
+      static const size_t blocksize = 1024*1024;
+      void writeBlock(const Sift::BlockHeader &header, const char *data);
+   public:
+      obstream(vostream *output, uint8_t codec, uint64_t offset);
+      virtual ~obstream();
+      virtual void write(const char* s, std::streamsize n)
+         { m_raw.insert(m_raw.end(), s, s + n); }
+      virtual void flush()
+         { endBlock(); output->flush(); }
+      virtual bool fail()
+         { return output->fail(); }
+      virtual bool is_open()
+         { return output->is_open(); }
+      void endBlock();
+      bool full() const { return m_raw.size() >= blocksize; }
+      uint64_t blocks() const { return m_index.size(); }
+      void addInstruction() { m_icount++; }
+      void addFlags(uint32_t flags) { m_block_flags |= flags; }
+      static bool supported(uint8_t codec);
+};
+
+// Block-compressed input (Sift::BlockIndex): blocks are decompressed one at a time into a reusable buffer.
+// On a seekable input, loadIndex() reads the block index and seekBlock() jumps to any block.
+class ibstream : public vistream
+{
+   private:
+      vistream *input;
+      bool m_eof;
+      bool m_fail;
+      std::vector<char> m_block;
+      size_t m_pos;  // Next byte to read from m_block
+      size_t m_len;  // End of the decompressed data in m_block
+      uint64_t m_offset;  // File offset of the next block header
+      std::vector<Sift::BlockIndexEntry> m_index;
+      uint64_t m_icount;  // Instructions in the trace, from the index trailer
+      bool fill(size_t n);
+   public:
+      ibstream(vistream *input, uint64_t offset);
+      virtual ~ibstream();
+      virtual void read(char* s, std::streamsize n);
+      virtual int peek();
+      virtual const char* readBuffer(std::streamsize n);
+      virtual bool fail() const { return m_fail; }
+      bool loadIndex(uint64_t filesize);
+      const std::vector<Sift::BlockIndexEntry>& getIndex() const { return m_index; }
+      uint64_t getInstructionCount() const { return m_icount; }
+      bool seekBlock(size_t block);
+};
+
 #endif // __ZFSTREAM_H
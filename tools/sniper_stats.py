@@ -30,6 +30,9 @@ class SniperStatsBase:
   def get_events(self):
     raise ValueError("Event information not available from statistics of this type")
 
+  def get_epochs(self):
+    raise ValueError("Epoch information not available from statistics of this type")
+
   def get_markers(self):
     markers = {}
     for event, time, core, thread, arg0, arg1, s in self.get_events():
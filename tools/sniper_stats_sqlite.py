@@ -58,6 +58,13 @@ class SniperStatsSqlite(sniper_stats.SniperStatsBase):
     c = self.db.cursor()
     return c.execute('SELECT event, time, core, thread, value0, value1, description FROM event').fetchall()
 
+  def get_epochs(self):
+    c = self.db.cursor()
+    if c.execute('SELECT name FROM sqlite_master WHERE type="table" AND name="epoch"').fetchall():
+      return c.execute('SELECT domain, eid, starttime, endtime, persisttime, instructions, dirtylines FROM epoch').fetchall()
+    else:
+      return []
+
 if __name__ == '__main__':
   stats = SniperStatsSqlite()
   print stats.get_snapshots()